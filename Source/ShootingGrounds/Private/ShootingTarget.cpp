@@ -3,6 +3,8 @@
 
 #include "ShootingTarget.h"
 #include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "ShooterPerfCounters.h"
 
 // Sets default values
 AShootingTarget::AShootingTarget()
@@ -12,6 +14,10 @@ AShootingTarget::AShootingTarget()
 
 	TargetMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("TargetMesh"));
 	RootComponent = TargetMesh;
+
+	// targets live on the server. Clients get the ones relevant to them
+	bReplicates = true;
+	SetReplicatingMovement(true);
 }
 
 // Called when the game starts or when spawned
@@ -21,10 +27,64 @@ void AShootingTarget::BeginPlay()
 	
 }
 
+void AShootingTarget::ActivateTarget(const FVector& Location, uint64 RequestCycles)
+{
+	SetActorLocation(Location, false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	bTargetActive = true;
+
+	// the target is only ready once a frame has run with it up, so check from the next tick on
+	ReadyRequestCycles = RequestCycles;
+}
+
+void AShootingTarget::CheckReady()
+{
+	// trace down through the target on the channel the weapons use to score hits
+	const FBox Bounds = GetComponentsBoundingBox();
+	const FVector Center = Bounds.GetCenter();
+	const FVector Top(Center.X, Center.Y, Bounds.Max.Z + 1.0f);
+
+	FHitResult Hit;
+
+	if (GetWorld()->LineTraceSingleByChannel(Hit, Top, Center, ECC_GameTraceChannel4) && Hit.GetActor() == this)
+	{
+		FShooterPerfCounters::Add(EShooterPerfScope::TargetReady, FPlatformTime::Cycles64() - ReadyRequestCycles);
+		ReadyRequestCycles = 0;
+	}
+}
+
+void AShootingTarget::DeactivateTarget()
+{
+	// hidden targets are skipped by traces and rendering, but keep their components and allocations
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	bTargetActive = false;
+	ReadyRequestCycles = 0;
+}
+
+void AShootingTarget::HandleHit()
+{
+	// ignore hits on targets that are already down
+	if (!bTargetActive)
+	{
+		return;
+	}
+
+	DeactivateTarget();
+	OnTargetHit.Broadcast(this);
+}
+
 // Called every frame
 void AShootingTarget::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (ReadyRequestCycles != 0)
+	{
+		CheckReady();
+	}
 }
 
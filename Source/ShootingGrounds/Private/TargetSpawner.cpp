@@ -6,6 +6,8 @@
 #include "Components/StaticMeshComponent.h"
 #include "ShootingTarget.h"
 #include "ShooterGameMode.h"
+#include "ShooterTrainingSession.h"
+#include "ShootingGrounds.h"
 
 // Sets default values
 ATargetSpawner::ATargetSpawner()
@@ -25,11 +27,26 @@ void ATargetSpawner::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// targets are spawned by the server and replicated. Spawners placed in a level hosting multiple sessions
+	// only serve as templates for each session's own instances
+	if (GetNetMode() == NM_Client || IsSessionTemplate())
+	{
+		return;
+	}
+
+	// until the first round is prepared, spawn from a random stream
+	Schedule.Stream.GenerateNewSeed();
+
 	SpawnTarget();
 }
 
 void ATargetSpawner::SpawnTarget()
 {
+	SHOOTER_SCOPE_STAT(SpawnTarget);
+
+	// when benchmarking, the target times how long it takes to become shootable from here
+	const uint64 RequestCycles = FShooterPerfCounters::IsEnabled() ? FPlatformTime::Cycles64() : 0;
+
 	if (!TargetClass) {
         UE_LOG(LogTemp, Warning, TEXT("TargetClass is not set on TargetSpawner!"));
         return;
@@ -39,44 +56,215 @@ void ATargetSpawner::SpawnTarget()
 	FVector Origin = RootComp->GetComponentLocation();
 	FVector Extent = RootComp->GetScaledBoxExtent();
 
-	// Generate random point within box
-	FVector RandomOffset = FVector(
-	FMath::FRandRange(-Extent.X, Extent.X),
-	FMath::FRandRange(-Extent.Y, Extent.Y),
-	FMath::FRandRange(-Extent.Z, Extent.Z)
-	);
+	// Pick the next point within the box from the round's schedule
+	FVector RandomOffset = GetNextSpawnOffset() * Extent;
 
 	FVector SpawnLocation = Origin + RandomOffset;
-	FRotator SpawnRotation = FRotator::ZeroRotator;
 
+	AShootingTarget* SpawnedTarget = AcquireTarget();
+
+	if (!SpawnedTarget)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to spawn target!"));
+		return;
+	}
+
+	SpawnedTarget->ActivateTarget(SpawnLocation, RequestCycles);
+	ActiveTarget = SpawnedTarget;
+
+	if (AShooterTrainingSession* Session = GetSession())
+	{
+		Session->OnTargetSpawned(SpawnedTarget);
+	}
+	UE_LOG(LogTemp, Display, TEXT("Target spawned at %s"), *SpawnLocation.ToString());
+}
+
+AShootingTarget* ATargetSpawner::AcquireTarget()
+{
+	// reuse a pooled target if we have one
+	if (TargetPool.Num() > 0)
+	{
+		return TargetPool.Pop(EAllowShrinking::No);
+	}
+
+	return CreateTarget();
+}
+
+AShootingTarget* ATargetSpawner::CreateTarget()
+{
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.Owner = this;
 	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
-	AShootingTarget* SpawnedTarget = GetWorld()->SpawnActor<AShootingTarget>(TargetClass, SpawnLocation, SpawnRotation, SpawnParams);
+	AShootingTarget* SpawnedTarget = GetWorld()->SpawnActor<AShootingTarget>(TargetClass, GetActorLocation(), FRotator::ZeroRotator, SpawnParams);
 
-	AShooterGameMode* GameMode = GetWorld() ? Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()) : nullptr;
-	if (GameMode)
+	if (SpawnedTarget)
 	{
-		GameMode->TargetSpawnTimes.Add(GetWorld()->GetTimeSeconds());
+		// a session's private targets are only replicated to that session's player
+		SpawnedTarget->bOnlyRelevantToOwner = GetOwner() != nullptr;
+
+		// hits return the target to the pool
+		SpawnedTarget->OnTargetHit.AddUObject(this, &ATargetSpawner::HandleTargetHit);
+
+		// Bind to OnDestroyed to respawn if something else destroys the target
+		SpawnedTarget->OnDestroyed.AddDynamic(this, &ATargetSpawner::HandleTargetDestroyed);
 	}
 
-	if (!SpawnedTarget)
+	return SpawnedTarget;
+}
+
+FVector ATargetSpawner::RandomBoxOffset(FRandomStream& Stream)
+{
+	// draw the components in a fixed order so a seed always gives the same points
+	const float X = Stream.FRandRange(-1.0f, 1.0f);
+	const float Y = Stream.FRandRange(-1.0f, 1.0f);
+	const float Z = Stream.FRandRange(-1.0f, 1.0f);
+
+	return FVector(X, Y, Z);
+}
+
+FVector ATargetSpawner::GetNextSpawnOffset()
+{
+	// pick up the schedule built during the break. It's normally done long before the round starts
+	if (PendingSchedule.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to spawn target!"));
-		return;
+		Schedule = MoveTemp(PendingSchedule.GetResult());
+		PendingSchedule = {};
+		NextScheduledSpawn = 0;
 	}
-	UE_LOG(LogTemp, Display, TEXT("Target spawned at %s"), *SpawnLocation.ToString());
 
-	// Bind to OnDestroyed to respawn
-	//SpawnedTarget->OnDestroyed.AddDynamic(this, &ATargetSpawner::HandleTargetDestroyed);
-	SpawnedTarget->OnDestroyed.AddDynamic(this, &ATargetSpawner::HandleTargetDestroyed);
+	if (Schedule.Offsets.IsValidIndex(NextScheduledSpawn))
+	{
+		return Schedule.Offsets[NextScheduledSpawn++];
+	}
+
+	// ran past the schedule, so keep drawing from the same stream
+	return RandomBoxOffset(Schedule.Stream);
+}
+
+void ATargetSpawner::PrepareRound(int32 Seed)
+{
+	// top up the pool on the game thread, since actors can only be spawned here
+	while (TargetClass && TargetPool.Num() < PoolSize)
+	{
+		AShootingTarget* Target = CreateTarget();
+
+		if (!Target)
+		{
+			break;
+		}
+
+		Target->DeactivateTarget();
+		TargetPool.Add(Target);
+	}
+
+	// build the spawn schedule in the background
+	const int32 NumOffsets = ScheduleSize;
+	const int32 StreamSeed = Seed != 0 ? Seed : FMath::Rand();
+
+	PendingSchedule = UE::Tasks::Launch(UE_SOURCE_LOCATION, [NumOffsets, StreamSeed]()
+	{
+		FTargetSpawnSchedule NewSchedule;
+		NewSchedule.Stream.Initialize(StreamSeed);
+		NewSchedule.Offsets.Reserve(NumOffsets);
+
+		for (int32 i = 0; i < NumOffsets; ++i)
+		{
+			NewSchedule.Offsets.Add(RandomBoxOffset(NewSchedule.Stream));
+		}
+
+		return NewSchedule;
+
+	}, UE::Tasks::ETaskPriority::BackgroundNormal);
+}
+
+void ATargetSpawner::HandleTargetHit(AShootingTarget* Target)
+{
+	UE_LOG(LogTemp, Display, TEXT("Target hit: %s"), *Target->GetName());
+
+	if (ActiveTarget == Target)
+	{
+		ActiveTarget = nullptr;
+	}
+
+	TargetPool.Add(Target);
+	SpawnTarget();
+}
+
+void ATargetSpawner::ResetSpawner()
+{
+	WithdrawTarget();
+	SpawnTarget();
+}
+
+void ATargetSpawner::WithdrawTarget()
+{
+	// put the current target back in the pool without counting it as a hit
+	if (ActiveTarget)
+	{
+		ActiveTarget->DeactivateTarget();
+
+		if (AShooterTrainingSession* Session = GetSession())
+		{
+			Session->OnTargetWithdrawn(ActiveTarget);
+		}
+
+		TargetPool.Add(ActiveTarget);
+		ActiveTarget = nullptr;
+	}
 }
 
 void ATargetSpawner::HandleTargetDestroyed(AActor* DestroyedActor)
 {
 	UE_LOG(LogTemp, Display, TEXT("Target destroyed: %s"), *DestroyedActor->GetName());
-	SpawnTarget();
+
+	// destroyed pooled targets are just forgotten
+	TargetPool.Remove(Cast<AShootingTarget>(DestroyedActor));
+
+	// only replace the target that was up
+	if (ActiveTarget == DestroyedActor)
+	{
+		ActiveTarget = nullptr;
+		SpawnTarget();
+	}
+}
+
+void ATargetSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// spawners removed along with their session take their targets with them
+	if (EndPlayReason == EEndPlayReason::Destroyed)
+	{
+		if (ActiveTarget)
+		{
+			TargetPool.Add(ActiveTarget);
+			ActiveTarget = nullptr;
+		}
+
+		for (AShootingTarget* Target : TargetPool)
+		{
+			if (IsValid(Target))
+			{
+				Target->OnDestroyed.RemoveDynamic(this, &ATargetSpawner::HandleTargetDestroyed);
+				Target->Destroy();
+			}
+		}
+
+		TargetPool.Reset();
+	}
+}
+
+AShooterTrainingSession* ATargetSpawner::GetSession() const
+{
+	const AShooterGameMode* GameMode = GetWorld() ? GetWorld()->GetAuthGameMode<AShooterGameMode>() : nullptr;
+	return GameMode ? GameMode->GetSessionForActor(this) : nullptr;
+}
+
+bool ATargetSpawner::IsSessionTemplate() const
+{
+	const AShooterGameMode* GameMode = GetWorld() ? GetWorld()->GetAuthGameMode<AShooterGameMode>() : nullptr;
+	return GameMode && GameMode->IsHostingMultipleSessions() && !GetOwner();
 }
 
 // Called every frame
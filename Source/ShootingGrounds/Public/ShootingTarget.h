@@ -7,6 +7,9 @@
 #include "ShootingTarget.generated.h"
 
 class UStaticMeshComponent;
+class AShootingTarget;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FShootingTargetHitDelegate, AShootingTarget* /* Target */);
 
 UCLASS()
 class SHOOTINGGROUNDS_API AShootingTarget : public AActor
@@ -19,10 +22,35 @@ public:
 	// Sets default values for this actor's properties
 	AShootingTarget();
 
+	// Called when the target is hit. The target is already deactivated
+	FShootingTargetHitDelegate OnTargetHit;
+
+	// Shows the target at the given location and makes it shootable
+	// When perf counters are on, the time from RequestCycles to the first frame the target can be shot is counted as TargetReady
+	void ActivateTarget(const FVector& Location, uint64 RequestCycles = 0);
+
+	// Hides the target so it can be reused later
+	void DeactivateTarget();
+
+	// Deactivates the target and notifies listeners that it was hit
+	void HandleHit();
+
+	// Returns true if the target is currently up
+	bool IsTargetActive() const { return bTargetActive; }
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// True while the target is shown and shootable
+	bool bTargetActive = true;
+
+	// Cycle count of the spawn request we're waiting to become shootable for, or zero
+	uint64 ReadyRequestCycles = 0;
+
+	// Counts the spawn request as ready once a trace on the target channel finds this target
+	void CheckReady();
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
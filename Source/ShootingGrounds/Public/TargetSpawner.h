@@ -4,12 +4,25 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Tasks/Task.h"
+#include "ShooterRoundConfig.h"
 #include "TargetSpawner.generated.h"
 
 class AShootingTarget;
+class AShooterTrainingSession;
 class UBoxComponent;
 class UStaticMeshComponent;
 
+// Spawn locations for a round, as offsets in the [-1, 1] range of the spawn box
+struct FTargetSpawnSchedule
+{
+	// Precomputed spawn offsets, in spawn order
+	TArray<FVector> Offsets;
+
+	// Stream to keep drawing from once the precomputed offsets run out
+	FRandomStream Stream;
+};
+
 UCLASS()
 class SHOOTINGGROUNDS_API ATargetSpawner : public AActor
 {
@@ -30,14 +43,80 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Destroys this spawner's targets if the spawner is removed during play
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void SpawnTarget();
 
+	// Returns the training session this spawner feeds
+	AShooterTrainingSession* GetSession() const;
+
+	// Returns true if this is a level placed spawner that each session copies instead of using directly
+	bool IsSessionTemplate() const;
+
+	// Returns a hidden target from the pool, or spawns a new one if the pool is empty
+	AShootingTarget* AcquireTarget();
+
+	// Spawns a new target and binds to its events
+	AShootingTarget* CreateTarget();
+
+	// Returns the next spawn offset from the round's schedule
+	FVector GetNextSpawnOffset();
+
+	// Draws a random offset in the [-1, 1] box from the stream
+	static FVector RandomBoxOffset(FRandomStream& Stream);
+
+	// Number of spawn locations precomputed for each round
+	UPROPERTY(EditAnywhere, Category="Spawning", meta = (ClampMin = 0, ClampMax = 4096))
+	int32 ScheduleSize = 256;
+
+	// Number of hidden targets kept ready in the pool between rounds
+	UPROPERTY(EditAnywhere, Category="Spawning", meta = (ClampMin = 0, ClampMax = 32))
+	int32 PoolSize = 2;
+
+	// Schedule for the current round
+	FTargetSpawnSchedule Schedule;
+
+	// Index of the next offset to use from the schedule
+	int32 NextScheduledSpawn = 0;
+
+	// Schedule for the next round, being built on a background task
+	UE::Tasks::TTask<FTargetSpawnSchedule> PendingSchedule;
+
 	UPROPERTY(EditAnywhere, Category="Spawning")
 	TSubclassOf<AShootingTarget> TargetClass;
 
+	// Drill this spawner serves. It only brings up targets during rounds running this drill
+	UPROPERTY(EditAnywhere, Category="Spawning")
+	EShooterDrillType DrillType = EShooterDrillType::Flick;
+
 	UFUNCTION()
 	void HandleTargetDestroyed(AActor* DestroyedActor);
 
+	// Returns a hit target to the pool and brings up the next one
+	void HandleTargetHit(AShootingTarget* Target);
+
+	// Target currently shown by this spawner
+	UPROPERTY(Transient)
+	TObjectPtr<AShootingTarget> ActiveTarget;
+
+	// Hidden targets waiting to be reused
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShootingTarget>> TargetPool;
+
+public:
+	// Hides the current target and brings up a fresh one, keeping the pooled targets
+	void ResetSpawner();
+
+	// Hides the current target without bringing up a new one, for rounds running another drill
+	void WithdrawTarget();
+
+	// Returns the drill this spawner serves
+	EShooterDrillType GetDrillType() const { return DrillType; }
+
+	// Prepares for the next round while the world keeps running: fills the pool and builds the spawn schedule in the background
+	void PrepareRound(int32 Seed);
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -21,7 +21,14 @@ public class ShootingGrounds : ModuleRules
 			"Slate"
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] { });
+		PrivateDependencyModuleNames.AddRange(new string[] {
+			"RHI",
+			"NetCore",
+			"SlateCore",
+			"SignificanceManager",
+			"MassEntity",
+			"GameplayTags"
+		});
 
 		PublicIncludePaths.AddRange(new string[] {
 			"ShootingGrounds",
@@ -29,6 +36,8 @@ public class ShootingGrounds : ModuleRules
 			"ShootingGrounds/Variant_Horror/UI",
 			"ShootingGrounds/Variant_Shooter",
 			"ShootingGrounds/Variant_Shooter/AI",
+			"ShootingGrounds/Variant_Shooter/Bot",
+			"ShootingGrounds/Variant_Shooter/Telemetry",
 			"ShootingGrounds/Variant_Shooter/UI",
 			"ShootingGrounds/Variant_Shooter/Weapons"
 		});
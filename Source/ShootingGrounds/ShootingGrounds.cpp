@@ -5,4 +5,36 @@
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ShootingGrounds, "ShootingGrounds" );
 
-DEFINE_LOG_CATEGORY(LogShootingGrounds)
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogShootingGrounds)
+
+DEFINE_STAT(STAT_ShooterWeaponFire);
+DEFINE_STAT(STAT_ShooterGunTrace);
+DEFINE_STAT(STAT_ShooterSpawnTarget);
+DEFINE_STAT(STAT_ShooterLineOfSight);
+DEFINE_STAT(STAT_ShooterLineOfSightCache);
+DEFINE_STAT(STAT_ShooterSenseEnemies);
+DEFINE_STAT(STAT_ShooterNPCAim);
+DEFINE_STAT(STAT_ShooterExplosionCheck);
+DEFINE_STAT(STAT_ShooterNPCSignificance);
+DEFINE_STAT(STAT_ShooterNPCCrowd);
+DEFINE_STAT(STAT_ShooterTeamPerception);
+DEFINE_STAT(STAT_ShooterRagdollBudget);
+DEFINE_STAT(STAT_ShooterNPCEvents);
+DEFINE_STAT(STAT_ShooterNPCStateTree);
+
+DEFINE_STAT(STAT_ShooterWeaponFireCalls);
+DEFINE_STAT(STAT_ShooterGunTraceCalls);
+DEFINE_STAT(STAT_ShooterSpawnTargetCalls);
+DEFINE_STAT(STAT_ShooterLineOfSightCalls);
+DEFINE_STAT(STAT_ShooterLineOfSightCacheCalls);
+DEFINE_STAT(STAT_ShooterSenseEnemiesCalls);
+DEFINE_STAT(STAT_ShooterNPCAimCalls);
+DEFINE_STAT(STAT_ShooterExplosionCheckCalls);
+DEFINE_STAT(STAT_ShooterNPCSignificanceCalls);
+DEFINE_STAT(STAT_ShooterNPCCrowdCalls);
+DEFINE_STAT(STAT_ShooterTeamPerceptionCalls);
+DEFINE_STAT(STAT_ShooterRagdollBudgetCalls);
+DEFINE_STAT(STAT_ShooterNPCEventsCalls);
+DEFINE_STAT(STAT_ShooterNPCStateTreeCalls);
+
+CSV_DEFINE_CATEGORY_MODULE(SHOOTINGGROUNDS_API, ShootingGrounds, true);
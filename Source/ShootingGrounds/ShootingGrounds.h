@@ -3,6 +3,53 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ShooterPerfCounters.h"
 
 /** Main log category used across the project */
-DECLARE_LOG_CATEGORY_EXTERN(LogShootingGrounds, Log, All);
\ No newline at end of file
+DECLARE_LOG_CATEGORY_EXTERN(LogShootingGrounds, Log, All);
+
+/** Stat group for gameplay hot paths. View with "stat ShootingGrounds" */
+DECLARE_STATS_GROUP(TEXT("ShootingGrounds"), STATGROUP_ShootingGrounds, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Weapon Fire"), STAT_ShooterWeaponFire, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Weapon Gun Trace"), STAT_ShooterGunTrace, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Target"), STAT_ShooterSpawnTarget, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Line Of Sight Condition"), STAT_ShooterLineOfSight, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Line Of Sight Cache Update"), STAT_ShooterLineOfSightCache, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sense Enemies"), STAT_ShooterSenseEnemies, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NPC Aim Location"), STAT_ShooterNPCAim, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Explosion Check"), STAT_ShooterExplosionCheck, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NPC Significance Update"), STAT_ShooterNPCSignificance, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NPC Crowd Update"), STAT_ShooterNPCCrowd, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Team Perception Update"), STAT_ShooterTeamPerception, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ragdoll Budget Update"), STAT_ShooterRagdollBudget, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NPC StateTree Events"), STAT_ShooterNPCEvents, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NPC StateTree Ticks"), STAT_ShooterNPCStateTree, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Weapon Fire Calls"), STAT_ShooterWeaponFireCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Weapon Gun Trace Calls"), STAT_ShooterGunTraceCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spawn Target Calls"), STAT_ShooterSpawnTargetCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line Of Sight Condition Calls"), STAT_ShooterLineOfSightCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line Of Sight Cache Update Calls"), STAT_ShooterLineOfSightCacheCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sense Enemies Calls"), STAT_ShooterSenseEnemiesCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("NPC Aim Location Calls"), STAT_ShooterNPCAimCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Explosion Check Calls"), STAT_ShooterExplosionCheckCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("NPC Significance Update Calls"), STAT_ShooterNPCSignificanceCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("NPC Crowd Update Calls"), STAT_ShooterNPCCrowdCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Team Perception Update Calls"), STAT_ShooterTeamPerceptionCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ragdoll Budget Update Calls"), STAT_ShooterRagdollBudgetCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("NPC StateTree Events Calls"), STAT_ShooterNPCEventsCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("NPC StateTree Ticks Calls"), STAT_ShooterNPCStateTreeCalls, STATGROUP_ShootingGrounds, SHOOTINGGROUNDS_API);
+
+/** CSV profiler category for gameplay hot paths. Capture with -csvCaptureFrames=N or "csvprofile start" */
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SHOOTINGGROUNDS_API, ShootingGrounds);
+
+/** Times the enclosing scope and counts the call on the stat group, the CSV profiler and the benchmark perf counters */
+#define SHOOTER_SCOPE_STAT(StatName) \
+	FShooterPerfScopeTimer ANONYMOUS_VARIABLE(ShooterPerfScope_)(EShooterPerfScope::StatName); \
+	SCOPE_CYCLE_COUNTER(STAT_Shooter##StatName); \
+	INC_DWORD_STAT(STAT_Shooter##StatName##Calls); \
+	CSV_SCOPED_TIMING_STAT(ShootingGrounds, StatName); \
+	CSV_CUSTOM_STAT(ShootingGrounds, StatName##Calls, 1, ECsvCustomStatOp::Accumulate)
@@ -3,15 +3,25 @@
 
 #include "Variant_Shooter/AI/ShooterAIController.h"
 #include "ShooterNPC.h"
-#include "Components/StateTreeAIComponent.h"
+#include "ShooterStateTreeAIComponent.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Navigation/PathFollowingComponent.h"
 #include "AI/Navigation/PathFollowingAgentInterface.h"
+#include "Perception/AISense_Sight.h"
+#include "ShooterTeamPerception.h"
+#include "ShooterLineOfSightSubsystem.h"
+#include "Camera/CameraComponent.h"
+#include "ShooterAITags.h"
+#include "Engine/World.h"
+#include "ShootingGrounds.h"
 
 AShooterAIController::AShooterAIController()
 {
+	// tick to process the perception updates in batches
+	PrimaryActorTick.bCanEverTick = true;
+
 	// create the StateTree component
-	StateTreeAI = CreateDefaultSubobject<UStateTreeAIComponent>(TEXT("StateTreeAI"));
+	StateTreeAI = CreateDefaultSubobject<UShooterStateTreeAIComponent>(TEXT("StateTreeAI"));
 
 	// create the AI perception component. It will be configured in BP
 	AIPerception = CreateDefaultSubobject<UAIPerceptionComponent>(TEXT("AIPerception"));
@@ -33,16 +43,114 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 
 		// subscribe to the pawn's OnDeath delegate
 		NPC->OnPawnDeath.AddDynamic(this, &AShooterAIController::OnPawnDeath);
+
+		JoinTeam();
 	}
 }
 
+void AShooterAIController::JoinTeam()
+{
+	// look for enemies together with the rest of the team
+	if (UShooterTeamPerception* TeamPerception = GetWorld()->GetSubsystem<UShooterTeamPerception>())
+	{
+		TeamPerception->RegisterMember(TeamTag, this);
+
+		if (TeamPerception->ReplacesNPCSight())
+		{
+			AIPerception->SetSenseEnabled(UAISense_Sight::StaticClass(), false);
+		}
+	}
+}
+
+void AShooterAIController::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// low detail NPCs hear about their surroundings less often
+	if (!PendingStimuli.IsEmpty() && Now - LastPerceptionBatchTime >= PerceptionInterval)
+	{
+		LastPerceptionBatchTime = Now;
+
+		// swap the queue out, so updates received while processing wait for the next frame
+		ProcessingStimuli.Reset();
+		Swap(ProcessingStimuli, PendingStimuli);
+
+		OnShooterPerceptionUpdated.ExecuteIfBound(ProcessingStimuli);
+	}
+
+	// nothing queued, nothing to turn towards and no move to follow, so sleep until one of those comes up
+	if (PendingStimuli.IsEmpty() && !FAISystem::IsValidLocation(GetFocalPoint()) && GetMoveStatus() == EPathFollowingStatus::Idle)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void AShooterAIController::WakeUp()
+{
+	SetActorTickEnabled(true);
+}
+
+void AShooterAIController::OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result)
+{
+	Super::OnMoveCompleted(RequestID, Result);
+
+	SendAIEvent(ShooterAITags::MoveCompleted);
+}
+
+FPathFollowingRequestResult AShooterAIController::MoveTo(const FAIMoveRequest& MoveRequest, FNavPathSharedPtr* OutPath)
+{
+	WakeUp();
+
+	return Super::MoveTo(MoveRequest, OutPath);
+}
+
+void AShooterAIController::SetFocus(AActor* NewFocus, EAIFocusPriority::Type InPriority)
+{
+	Super::SetFocus(NewFocus, InPriority);
+
+	WakeUp();
+}
+
+void AShooterAIController::SetFocalPoint(FVector NewFocus, EAIFocusPriority::Type InPriority)
+{
+	Super::SetFocalPoint(NewFocus, InPriority);
+
+	WakeUp();
+}
+
+void AShooterAIController::SendAIEvent(const FGameplayTag& Tag)
+{
+	// damage still reaches dead and pooled NPCs, whose StateTree is stopped
+	if (!StateTreeAI || bLogicSuspended)
+	{
+		return;
+	}
+
+	const AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+	if (NPC && NPC->IsDormant())
+	{
+		return;
+	}
+
+	SHOOTER_SCOPE_STAT(NPCEvents);
+
+	StateTreeAI->SendStateTreeEvent(Tag);
+}
+
 void AShooterAIController::OnPawnDeath()
 {
-	// stop movement
-	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
+	SuspendLogic();
 
-	// stop StateTree logic
-	StateTreeAI->StopLogic(FString(""));
+	// pooled NPCs keep their controller for their next life
+	const AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+	if (NPC && NPC->IsPooled())
+	{
+		return;
+	}
 
 	// unpossess the pawn
 	UnPossess();
@@ -51,6 +159,38 @@ void AShooterAIController::OnPawnDeath()
 	Destroy();
 }
 
+void AShooterAIController::SuspendLogic()
+{
+	// leave the team
+	if (UShooterTeamPerception* TeamPerception = GetWorld()->GetSubsystem<UShooterTeamPerception>())
+	{
+		TeamPerception->UnregisterMember(TeamTag, this);
+	}
+
+	// stop movement
+	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
+
+	// stop StateTree logic
+	bLogicSuspended = true;
+	StateTreeAI->StopLogic(FString(""));
+
+	// forget what we were fighting
+	ClearCurrentTarget();
+	ClearFocus(EAIFocusPriority::Gameplay);
+	PendingStimuli.Reset();
+	SensedLineOfSight.Reset();
+}
+
+void AShooterAIController::ResumeLogic()
+{
+	JoinTeam();
+
+	bLogicSuspended = false;
+
+	// start the StateTree over
+	StateTreeAI->RestartLogic();
+}
+
 void AShooterAIController::SetCurrentTarget(AActor* Target)
 {
 	TargetEnemy = Target;
@@ -61,14 +201,141 @@ void AShooterAIController::ClearCurrentTarget()
 	TargetEnemy = nullptr;
 }
 
+void AShooterAIController::SetUpdateIntervals(float StateTreeInterval, float InPerceptionInterval)
+{
+	StateTreeAI->SetComponentTickInterval(StateTreeInterval);
+	PerceptionInterval = InPerceptionInterval;
+}
+
+void AShooterAIController::QueueTeamSighting(AActor* Enemy, const FVector& Location, float Confidence, bool bVisible)
+{
+	// team knowledge goes through the same batch as our own senses
+	FAIStimulus Stimulus;
+	Stimulus.StimulusLocation = Location;
+	Stimulus.ReceiverLocation = GetPawn() ? GetPawn()->GetActorLocation() : FVector::ZeroVector;
+	Stimulus.Strength = Confidence;
+
+	QueueStimulus(Enemy, Stimulus, bVisible, bVisible);
+}
+
+void AShooterAIController::ForgetTeamSighting(AActor* Enemy)
+{
+	SensedLineOfSight.Remove(Enemy);
+
+	OnShooterPerceptionForgotten.ExecuteIfBound(Enemy);
+}
+
+void AShooterAIController::SetLineOfSight(AActor* Actor, bool bHasLineOfSight, int32 NumChecks)
+{
+	FShooterLineOfSightRecord& Record = SensedLineOfSight.FindOrAdd(Actor);
+	Record.bHasLineOfSight = bHasLineOfSight;
+	Record.Time = GetWorld()->GetTimeSeconds();
+	Record.NumChecks = NumChecks;
+}
+
+bool AShooterAIController::HasLineOfSightTo(const AActor* Actor) const
+{
+	// an old line of sight is unknown, not trusted
+	const FShooterLineOfSightRecord* Record = SensedLineOfSight.Find(Actor);
+	return Record && Record->bHasLineOfSight && GetWorld()->GetTimeSeconds() - Record->Time <= LineOfSightMaxAge;
+}
+
+void AShooterAIController::RefreshLineOfSight(AActor* Actor)
+{
+	FShooterLineOfSightRecord* Record = SensedLineOfSight.Find(Actor);
+	const AShooterNPC* NPC = Cast<AShooterNPC>(GetPawn());
+
+	// only sensed actors are refreshed, once at a time, early enough for the result to arrive before the old one expires
+	if (!Record || Record->bRefreshing || !NPC || GetWorld()->GetTimeSeconds() - Record->Time < LineOfSightMaxAge * 0.5f)
+	{
+		return;
+	}
+
+	UShooterLineOfSightSubsystem* LineOfSight = GetWorld()->GetSubsystem<UShooterLineOfSightSubsystem>();
+
+	if (!LineOfSight)
+	{
+		return;
+	}
+
+	// look from the same camera as the perception batches, so both share the cache entry
+	Record->bRefreshing = true;
+	LineOfSight->RequestLineOfSight(GetPawn(), NPC->GetFirstPersonCameraComponent()->GetComponentLocation(), Actor, Record->NumChecks,
+		FShooterLineOfSightDelegate::CreateUObject(this, &AShooterAIController::OnLineOfSightRefreshed, TWeakObjectPtr<AActor>(Actor)));
+}
+
+void AShooterAIController::OnLineOfSightRefreshed(bool bHasLineOfSight, TWeakObjectPtr<AActor> Actor)
+{
+	// the actor may have been forgotten while the refresh was pending
+	AActor* RefreshedActor = Actor.Get();
+	FShooterLineOfSightRecord* Record = RefreshedActor ? SensedLineOfSight.Find(RefreshedActor) : nullptr;
+
+	if (!Record)
+	{
+		return;
+	}
+
+	Record->bRefreshing = false;
+
+	const bool bHadLineOfSight = HasLineOfSightTo(RefreshedActor);
+	SetLineOfSight(RefreshedActor, bHasLineOfSight, Record->NumChecks);
+
+	// let the conditions reading it have another look
+	if (bHadLineOfSight != bHasLineOfSight)
+	{
+		SendAIEvent(ShooterAITags::PerceptionUpdated);
+	}
+}
+
 void AShooterAIController::OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus)
 {
-	// pass the data to the StateTree delegate hook
-	OnShooterPerceptionUpdated.ExecuteIfBound(Actor, Stimulus);
+	QueueStimulus(Actor, Stimulus, false, Stimulus.WasSuccessfullySensed());
+}
+
+void AShooterAIController::QueueStimulus(AActor* Actor, const FAIStimulus& Stimulus, bool bTeamSighting, bool bSensed)
+{
+	// nobody is listening, so there's nothing to queue
+	if (!OnShooterPerceptionUpdated.IsBound())
+	{
+		return;
+	}
+
+	// stimuli come in bursts under gunfire. Keep only the strongest one per actor until the next tick
+	FShooterSensedStimulus* Pending = PendingStimuli.FindByPredicate([Actor](const FShooterSensedStimulus& Sensed) { return Sensed.Actor == Actor; });
+
+	if (!Pending)
+	{
+		// we may have been sleeping
+		if (PendingStimuli.IsEmpty())
+		{
+			WakeUp();
+		}
+
+		Pending = &PendingStimuli.AddDefaulted_GetRef();
+		Pending->Actor = Actor;
+		Pending->Stimulus = Stimulus;
+		Pending->bTeamSighting = bTeamSighting;
+		Pending->bSensed = bSensed;
+
+	} else {
+
+		if (Stimulus.Strength >= Pending->Stimulus.Strength)
+		{
+			Pending->Stimulus = Stimulus;
+		}
+
+		// a team sighting this frame holds whatever else we sensed
+		Pending->bTeamSighting |= bTeamSighting;
+
+		// losing sight is weak, so it rarely is the strongest stimulus. It still has the last word on whether the actor is in view
+		Pending->bSensed = bSensed;
+	}
 }
 
 void AShooterAIController::OnPerceptionForgotten(AActor* Actor)
 {
+	SensedLineOfSight.Remove(Actor);
+
 	// pass the data to the StateTree delegate hook
 	OnShooterPerceptionForgotten.ExecuteIfBound(Actor);
 }
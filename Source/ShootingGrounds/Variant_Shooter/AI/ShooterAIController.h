@@ -4,13 +4,51 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "Perception/AIPerceptionTypes.h"
+#include "UObject/ObjectKey.h"
 #include "ShooterAIController.generated.h"
 
-class UStateTreeAIComponent;
+class UShooterStateTreeAIComponent;
 class UAIPerceptionComponent;
-struct FAIStimulus;
+struct FGameplayTag;
 
-DECLARE_DELEGATE_TwoParams(FShooterPerceptionUpdatedDelegate, AActor*, const FAIStimulus&);
+/**
+ *  Strongest stimulus received from an actor during a frame
+ */
+struct FShooterSensedStimulus
+{
+	/** Actor that caused the stimulus */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Stimulus data */
+	FAIStimulus Stimulus;
+
+	/** True if the team has the actor in sight. The receiving NPC still checks its own line of sight */
+	bool bTeamSighting = false;
+
+	/** False if the newest stimulus from the actor this frame reported it lost, even if a stronger one came before it */
+	bool bSensed = true;
+};
+
+/**
+ *  Line of sight to a sensed actor, as found by a perception batch or a refresh
+ */
+struct FShooterLineOfSightRecord
+{
+	/** True if the actor was in line of sight */
+	bool bHasLineOfSight = false;
+
+	/** World time the line of sight was found */
+	double Time = 0.0;
+
+	/** Number of vertical checks it was found with, reused by refreshes */
+	int32 NumChecks = 1;
+
+	/** True while a refresh is on its way */
+	bool bRefreshing = false;
+};
+
+DECLARE_DELEGATE_OneParam(FShooterPerceptionUpdatedDelegate, const TArray<FShooterSensedStimulus>&);
 DECLARE_DELEGATE_OneParam(FShooterPerceptionForgottenDelegate, AActor*);
 
 /**
@@ -23,7 +61,7 @@ class SHOOTINGGROUNDS_API AShooterAIController : public AAIController
 	
 	/** Runs the behavior StateTree for this NPC */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
-	UStateTreeAIComponent* StateTreeAI;
+	UShooterStateTreeAIComponent* StateTreeAI;
 
 	/** Detects other actors through sight, hearing and other senses */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
@@ -35,12 +73,34 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Shooter")
 	FName TeamTag = FName("Enemy");
 
+	/** Time a line of sight to a sensed actor is trusted for, in seconds. Older ones count as no line of sight until refreshed */
+	UPROPERTY(EditAnywhere, Category="Shooter", meta = (ClampMin = 0, Units = "s"))
+	float LineOfSightMaxAge = 1.0f;
+
 	/** Enemy currently being targeted */
 	TObjectPtr<AActor> TargetEnemy;
 
+	/** Stimuli received since the last tick, one per sensed actor */
+	TArray<FShooterSensedStimulus> PendingStimuli;
+
+	/** Stimuli being handed to the StateTree. Kept around to reuse the allocation */
+	TArray<FShooterSensedStimulus> ProcessingStimuli;
+
+	/** Minimum time between perception batches, in seconds. Zero hands them over every frame */
+	float PerceptionInterval = 0.0f;
+
+	/** World time the last perception batch was handed over */
+	double LastPerceptionBatchTime = 0.0;
+
+	/** Line of sight to each sensed actor, as found by the latest perception batch that included it or a later refresh */
+	TMap<TObjectKey<AActor>, FShooterLineOfSightRecord> SensedLineOfSight;
+
+	/** If true, the StateTree is stopped while the pawn is dead or pooled */
+	bool bLogicSuspended = false;
+
 public:
 
-	/** Called when an AI perception has been updated. StateTree task delegate hook */
+	/** Called once per frame with the AI perceptions updated during that frame. StateTree task delegate hook */
 	FShooterPerceptionUpdatedDelegate OnShooterPerceptionUpdated;
 
 	/** Called when an AI perception has been forgotten. StateTree task delegate hook */
@@ -56,6 +116,23 @@ protected:
 	/** Pawn initialization */
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/** Hands the queued perception updates to the StateTree, and stops ticking while there's nothing to do */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Tells the StateTree the move is over */
+	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
+
+public:
+
+	/** Wakes the controller up to follow the move */
+	virtual FPathFollowingRequestResult MoveTo(const FAIMoveRequest& MoveRequest, FNavPathSharedPtr* OutPath = nullptr) override;
+
+	/** Wakes the controller up to turn towards the new focus */
+	virtual void SetFocus(AActor* NewFocus, EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay) override;
+
+	/** Wakes the controller up to turn towards the new focal point */
+	virtual void SetFocalPoint(FVector NewFocus, EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay) override;
+
 protected:
 
 	/** Called when the possessed pawn dies */
@@ -70,11 +147,56 @@ public:
 	/** Clears the targeted enemy */
 	void ClearCurrentTarget();
 
+	/** Queues what the team knows about an enemy for the next perception batch */
+	void QueueTeamSighting(AActor* Enemy, const FVector& Location, float Confidence, bool bVisible);
+
+	/** Forgets an enemy the team lost track of */
+	void ForgetTeamSighting(AActor* Enemy);
+
 	/** Returns the targeted enemy */
 	AActor* GetCurrentTarget() const { return TargetEnemy; };
 
+	/** Stores the line of sight to a sensed actor. Called as the perception batches are applied */
+	void SetLineOfSight(AActor* Actor, bool bHasLineOfSight, int32 NumChecks);
+
+	/** Returns the line of sight to a sensed actor as of the latest perception batch or refresh, or false if it's too old. Doesn't trace */
+	bool HasLineOfSightTo(const AActor* Actor) const;
+
+	/**
+	 *  Refreshes the line of sight to a sensed actor through the line of sight cache once it's halfway to expiring,
+	 *  so it's kept up while something asks for it. Sends PerceptionUpdated if the refresh changes what HasLineOfSightTo returns
+	 */
+	void RefreshLineOfSight(AActor* Actor);
+
+	/** Returns the StateTree component, with its tick stats */
+	UShooterStateTreeAIComponent* GetStateTreeComponent() const { return StateTreeAI; }
+
+	/** Slows down the StateTree and the perception updates. Intervals are in seconds, zero updates every frame */
+	void SetUpdateIntervals(float StateTreeInterval, float InPerceptionInterval);
+
+	/** Stops the StateTree, movement and team sight while the pawn is dead or pooled */
+	void SuspendLogic();
+
+	/** Rejoins the team and restarts the StateTree from the top, after the pawn comes back from its pool */
+	void ResumeLogic();
+
+	/** Sends an event to the StateTree, waking it up if it's sleeping. Dropped while the logic is suspended */
+	void SendAIEvent(const FGameplayTag& Tag);
+
 protected:
 
+	/** Looks for enemies together with the rest of the team */
+	void JoinTeam();
+
+	/** Starts ticking again after sleeping */
+	void WakeUp();
+
+	/** Adds a stimulus to the next perception batch, keeping the strongest one and the newest sensed or lost state per actor */
+	void QueueStimulus(AActor* Actor, const FAIStimulus& Stimulus, bool bTeamSighting, bool bSensed);
+
+	/** Stores a refreshed line of sight */
+	void OnLineOfSightRefreshed(bool bHasLineOfSight, TWeakObjectPtr<AActor> Actor);
+
 	/** Called when the AI perception component updates a perception on a given actor */
 	UFUNCTION()
 	void OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus);
@@ -0,0 +1,12 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterAITags.h"
+
+namespace ShooterAITags
+{
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(PerceptionUpdated, "Shooter.AI.Event.PerceptionUpdated", "The Sense Enemies task processed a perception batch");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(PerceptionForgotten, "Shooter.AI.Event.PerceptionForgotten", "The Sense Enemies task forgot a sensed actor");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(MoveCompleted, "Shooter.AI.Event.MoveCompleted", "The NPC finished or aborted a move");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Damaged, "Shooter.AI.Event.Damaged", "The NPC took damage and survived");
+}
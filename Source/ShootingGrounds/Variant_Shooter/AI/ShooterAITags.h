@@ -0,0 +1,24 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "NativeGameplayTags.h"
+
+/**
+ *  StateTree events sent to the NPC StateTrees
+ *  Trees transition on these instead of polling every tick, so an idle NPC's tree can sleep until one arrives
+ */
+namespace ShooterAITags
+{
+	/** The Sense Enemies task processed a perception batch */
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(PerceptionUpdated);
+
+	/** The Sense Enemies task forgot a sensed actor */
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(PerceptionForgotten);
+
+	/** The NPC finished or aborted a move */
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(MoveCompleted);
+
+	/** The NPC took damage and survived */
+	UE_DECLARE_GAMEPLAY_TAG_EXTERN(Damaged);
+}
@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "ShooterCrowdFragments.generated.h"
+
+/**
+ *  Where a crowd NPC is and which way it faces
+ */
+USTRUCT()
+struct FShooterCrowdTransformFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** World location */
+	FVector Location = FVector::ZeroVector;
+
+	/** Facing, in degrees */
+	float Yaw = 0.0f;
+};
+
+/**
+ *  Team a crowd NPC scores for
+ */
+USTRUCT()
+struct FShooterCrowdTeamFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** Team byte, as on AShooterNPC */
+	uint8 TeamByte = 1;
+};
+
+/**
+ *  Remaining HP of a crowd NPC, carried over when it becomes an actor and back
+ */
+USTRUCT()
+struct FShooterCrowdHealthFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** Current HP */
+	float HP = 100.0f;
+};
+
+/**
+ *  Straight line move to a destination around the NPC's home
+ */
+USTRUCT()
+struct FShooterCrowdMoveFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** Center of the area the NPC wanders around */
+	FVector Home = FVector::ZeroVector;
+
+	/** Location the NPC is moving to */
+	FVector Destination = FVector::ZeroVector;
+};
+
+/**
+ *  Refire state of a crowd NPC
+ */
+USTRUCT()
+struct FShooterCrowdFireFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** Time until the NPC can fire again, in seconds */
+	float TimeUntilNextShot = 0.0f;
+};
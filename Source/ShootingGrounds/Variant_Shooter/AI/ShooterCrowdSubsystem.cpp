@@ -0,0 +1,319 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterCrowdSubsystem.h"
+#include "ShooterCrowdFragments.h"
+#include "ShooterNPC.h"
+#include "MassEntitySubsystem.h"
+#include "MassEntityManager.h"
+#include "MassExecutionContext.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "ShootingGrounds.h"
+
+void UShooterCrowdSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UMassEntitySubsystem* EntitySubsystem = Collection.InitializeDependency<UMassEntitySubsystem>();
+	EntityManager = EntitySubsystem->GetMutableEntityManager().AsShared();
+
+	// every crowd NPC has the same fragments, so they all share one archetype
+	Archetype = EntityManager->CreateArchetype({
+		FShooterCrowdTransformFragment::StaticStruct(),
+		FShooterCrowdTeamFragment::StaticStruct(),
+		FShooterCrowdHealthFragment::StaticStruct(),
+		FShooterCrowdMoveFragment::StaticStruct(),
+		FShooterCrowdFireFragment::StaticStruct()
+	});
+
+	CrowdQuery = FMassEntityQuery(EntityManager.ToSharedRef());
+	CrowdQuery.AddRequirement<FShooterCrowdTransformFragment>(EMassFragmentAccess::ReadWrite);
+	CrowdQuery.AddRequirement<FShooterCrowdMoveFragment>(EMassFragmentAccess::ReadWrite);
+	CrowdQuery.AddRequirement<FShooterCrowdFireFragment>(EMassFragmentAccess::ReadWrite);
+
+	Stream.GenerateNewSeed();
+}
+
+void UShooterCrowdSubsystem::Deinitialize()
+{
+	// the entities go away with the entity manager
+	EntityManager.Reset();
+	Actors.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UShooterCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterCrowdSubsystem::SpawnCrowd(const FVector& Center, float Radius, int32 Count, uint8 TeamByte)
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		CreateEntity(RandomPointAround(Center, Radius), Stream.FRandRange(-180.0f, 180.0f), 100.0f, TeamByte);
+	}
+}
+
+void UShooterCrowdSubsystem::CreateEntity(const FVector& Location, float Yaw, float HP, uint8 TeamByte)
+{
+	const FMassEntityHandle Entity = EntityManager->CreateEntity(Archetype);
+
+	FShooterCrowdTransformFragment& Transform = EntityManager->GetFragmentDataChecked<FShooterCrowdTransformFragment>(Entity);
+	Transform.Location = Location;
+	Transform.Yaw = Yaw;
+
+	EntityManager->GetFragmentDataChecked<FShooterCrowdTeamFragment>(Entity).TeamByte = TeamByte;
+	EntityManager->GetFragmentDataChecked<FShooterCrowdHealthFragment>(Entity).HP = HP;
+
+	FShooterCrowdMoveFragment& Move = EntityManager->GetFragmentDataChecked<FShooterCrowdMoveFragment>(Entity);
+	Move.Home = Location;
+	Move.Destination = RandomPointAround(Location, WanderRadius);
+
+	++NumEntities;
+}
+
+FVector UShooterCrowdSubsystem::RandomPointAround(const FVector& Center, float Radius)
+{
+	// uniform over the disc
+	const float Angle = Stream.FRandRange(0.0f, UE_TWO_PI);
+	const float Distance = Radius * FMath::Sqrt(Stream.FRand());
+
+	return Center + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.0f);
+}
+
+void UShooterCrowdSubsystem::Tick(float DeltaTime)
+{
+	if (!EntityManager.IsValid())
+	{
+		return;
+	}
+
+	SHOOTER_SCOPE_STAT(NPCCrowd);
+
+	// the crowd reacts to player pawns, simulated players included
+	Players.Reset();
+	PlayerLocations.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr)
+		{
+			Players.Add(Pawn);
+			PlayerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	PendingPromotions.Reset();
+	PendingHits.Init(0, Players.Num());
+
+	if (NumEntities > 0)
+	{
+		const float PromotionRadiusSquared = FMath::Square(PromotionRadius);
+		const float FireRangeSquared = FMath::Square(FireRange);
+		// without an actor class to promote to, crowd NPCs stay in the crowd
+		const int32 MaxPromotions = NPCClass.IsNull() ? 0 : FMath::Min(MaxPromotionsPerFrame, MaxActors - Actors.Num());
+
+		FMassExecutionContext Context(*EntityManager, DeltaTime);
+
+		CrowdQuery.ForEachEntityChunk(Context, [&, this](FMassExecutionContext& ChunkContext)
+		{
+			const TArrayView<FShooterCrowdTransformFragment> Transforms = ChunkContext.GetMutableFragmentView<FShooterCrowdTransformFragment>();
+			const TArrayView<FShooterCrowdMoveFragment> Moves = ChunkContext.GetMutableFragmentView<FShooterCrowdMoveFragment>();
+			const TArrayView<FShooterCrowdFireFragment> Fires = ChunkContext.GetMutableFragmentView<FShooterCrowdFireFragment>();
+
+			for (int32 i = 0; i < ChunkContext.GetNumEntities(); ++i)
+			{
+				FShooterCrowdTransformFragment& Transform = Transforms[i];
+				FShooterCrowdMoveFragment& Move = Moves[i];
+
+				// move in a straight line, and pick the next destination once there
+				const FVector ToDestination = Move.Destination - Transform.Location;
+				const float Distance = ToDestination.Size();
+				const float Step = MoveSpeed * DeltaTime;
+
+				if (Distance <= Step)
+				{
+					Transform.Location = Move.Destination;
+					Move.Destination = RandomPointAround(Move.Home, WanderRadius);
+
+				} else {
+
+					Transform.Location += ToDestination * (Step / Distance);
+					Transform.Yaw = ToDestination.Rotation().Yaw;
+				}
+
+				// find the closest player
+				int32 ClosestPlayer = INDEX_NONE;
+				float ClosestDistanceSquared = TNumericLimits<float>::Max();
+
+				for (int32 PlayerIndex = 0; PlayerIndex < PlayerLocations.Num(); ++PlayerIndex)
+				{
+					const float DistanceSquared = FVector::DistSquared(Transform.Location, PlayerLocations[PlayerIndex]);
+
+					if (DistanceSquared < ClosestDistanceSquared)
+					{
+						ClosestPlayer = PlayerIndex;
+						ClosestDistanceSquared = DistanceSquared;
+					}
+				}
+
+				if (ClosestPlayer == INDEX_NONE)
+				{
+					continue;
+				}
+
+				// close enough to need a real actor
+				if (ClosestDistanceSquared <= PromotionRadiusSquared && PendingPromotions.Num() < MaxPromotions)
+				{
+					PendingPromotions.Add(ChunkContext.GetEntity(i));
+					continue;
+				}
+
+				// fire at the closest player from a distance
+				FShooterCrowdFireFragment& Fire = Fires[i];
+				Fire.TimeUntilNextShot -= DeltaTime;
+
+				if (FireRange > 0.0f && ClosestDistanceSquared <= FireRangeSquared && Fire.TimeUntilNextShot <= 0.0f)
+				{
+					Fire.TimeUntilNextShot = RefireTime;
+
+					if (Stream.FRand() < HitChance)
+					{
+						++PendingHits[ClosestPlayer];
+					}
+				}
+			}
+		});
+
+		// entities can only be destroyed outside of the query
+		for (const FMassEntityHandle& Entity : PendingPromotions)
+		{
+			if (!Promote(Entity))
+			{
+				break;
+			}
+		}
+
+		// apply the crowd hits
+		for (int32 PlayerIndex = 0; PlayerIndex < Players.Num(); ++PlayerIndex)
+		{
+			if (PendingHits[PlayerIndex] > 0 && Players[PlayerIndex].IsValid())
+			{
+				UGameplayStatics::ApplyDamage(Players[PlayerIndex].Get(), HitDamage * PendingHits[PlayerIndex], nullptr, nullptr, UDamageType::StaticClass());
+			}
+		}
+	}
+
+	UpdateActors();
+}
+
+bool UShooterCrowdSubsystem::Promote(FMassEntityHandle Entity)
+{
+	UClass* Class = NPCClass.LoadSynchronous();
+
+	if (!Class)
+	{
+		UE_LOG(LogShootingGrounds, Warning, TEXT("ShooterCrowd: couldn't load %s, crowd NPCs can't be promoted"), *NPCClass.ToString());
+		return false;
+	}
+
+	const FShooterCrowdTransformFragment& Transform = EntityManager->GetFragmentDataChecked<FShooterCrowdTransformFragment>(Entity);
+
+	// the crowd moves on a flat plane, so stand the actor on whatever ground is below or above it
+	FVector Location = Transform.Location;
+	FHitResult GroundHit;
+	const FVector TraceOffset(0.0f, 0.0f, GroundTraceDistance);
+
+	if (GetWorld()->LineTraceSingleByChannel(GroundHit, Location + TraceOffset, Location - TraceOffset, ECC_Visibility, FCollisionQueryParams(SCENE_QUERY_STAT(ShooterCrowdGround), false)))
+	{
+		Location = GroundHit.ImpactPoint + FVector(0.0f, 0.0f, Class->GetDefaultObject<AShooterNPC>()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	AShooterNPC* NPC = GetWorld()->SpawnActor<AShooterNPC>(Class, Location, FRotator(0.0f, Transform.Yaw, 0.0f), SpawnParams);
+
+	if (!NPC)
+	{
+		return false;
+	}
+
+	// carry the crowd state over to the actor
+	NPC->CurrentHP = EntityManager->GetFragmentDataChecked<FShooterCrowdHealthFragment>(Entity).HP;
+	NPC->SetTeamByte(EntityManager->GetFragmentDataChecked<FShooterCrowdTeamFragment>(Entity).TeamByte);
+
+	// spawned pawns only get their AI controller if the class asks for it
+	if (!NPC->GetController())
+	{
+		NPC->SpawnDefaultController();
+	}
+
+	Actors.Add(NPC);
+
+	EntityManager->DestroyEntity(Entity);
+	--NumEntities;
+
+	return true;
+}
+
+void UShooterCrowdSubsystem::Demote(AShooterNPC* NPC)
+{
+	CreateEntity(NPC->GetActorLocation(), NPC->GetActorRotation().Yaw, NPC->CurrentHP, NPC->GetTeamByte());
+
+	// the controller goes with the pawn
+	if (AController* Controller = NPC->GetController())
+	{
+		Controller->Destroy();
+	}
+
+	NPC->Destroy();
+}
+
+void UShooterCrowdSubsystem::UpdateActors()
+{
+	// without players there's nothing to be far from
+	const bool bCanDemote = !PlayerLocations.IsEmpty();
+	const float DemotionRadiusSquared = FMath::Square(DemotionRadius);
+	int32 NumDemoted = 0;
+
+	for (int32 i = Actors.Num() - 1; i >= 0; --i)
+	{
+		AShooterNPC* NPC = Actors[i].Get();
+
+		// dead NPCs clean up after themselves
+		if (!NPC || NPC->IsDead())
+		{
+			Actors.RemoveAtSwap(i);
+			continue;
+		}
+
+		// keep NPCs that are fighting or near any player
+		if (!bCanDemote || NumDemoted >= MaxDemotionsPerFrame || NPC->IsInCombat())
+		{
+			continue;
+		}
+
+		const FVector Location = NPC->GetActorLocation();
+
+		if (PlayerLocations.ContainsByPredicate([&](const FVector& PlayerLocation) { return FVector::DistSquared(Location, PlayerLocation) <= DemotionRadiusSquared; }))
+		{
+			continue;
+		}
+
+		Actors.RemoveAtSwap(i);
+		Demote(NPC);
+		++NumDemoted;
+	}
+}
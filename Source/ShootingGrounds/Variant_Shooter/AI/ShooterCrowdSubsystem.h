@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MassEntityQuery.h"
+#include "MassArchetypeTypes.h"
+#include "ShooterCrowdSubsystem.generated.h"
+
+class AShooterNPC;
+struct FMassEntityManager;
+
+/**
+ *  Simulates NPCs far from every player as Mass entities instead of actors
+ *  Crowd NPCs are a handful of fragments: location, team, HP, a straight line move around their home and a refire
+ *  timer. They're processed in chunks by a single entity query, so thousands of them cost less than a few actors.
+ *  Crowd NPCs that come within the promotion radius of a player become full AShooterNPC actors with their AI controller,
+ *  and actors that wander past the demotion radius go back to the crowd. Both are capped per frame, and the
+ *  number of actors is capped overall, to keep the game thread cost bounded.
+ *  Crowd NPCs move on a flat plane at their home's height. A single trace puts them on the ground as they're promoted
+ *  Settings live under [/Script/ShootingGrounds.ShooterCrowdSubsystem] in DefaultGame.ini
+ */
+UCLASS(Config=Game)
+class SHOOTINGGROUNDS_API UShooterCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** NPC actor crowd NPCs are promoted to */
+	UPROPERTY(Config)
+	TSoftClassPtr<AShooterNPC> NPCClass;
+
+	/** Distance to a player at which a crowd NPC becomes an actor, in cm */
+	UPROPERTY(Config)
+	float PromotionRadius = 3000.0f;
+
+	/** Distance to every player at which an actor goes back to the crowd, in cm. Larger than the promotion radius to avoid flip flopping */
+	UPROPERTY(Config)
+	float DemotionRadius = 4000.0f;
+
+	/** Most crowd NPCs promoted on a single frame */
+	UPROPERTY(Config)
+	int32 MaxPromotionsPerFrame = 4;
+
+	/** Most actors demoted on a single frame */
+	UPROPERTY(Config)
+	int32 MaxDemotionsPerFrame = 4;
+
+	/** Most promoted actors at once. Crowd NPCs past this wait their turn */
+	UPROPERTY(Config)
+	int32 MaxActors = 64;
+
+	/** Crowd NPC movement speed, in cm/s */
+	UPROPERTY(Config)
+	float MoveSpeed = 300.0f;
+
+	/** Distance from home crowd NPCs pick their destinations in, in cm */
+	UPROPERTY(Config)
+	float WanderRadius = 2000.0f;
+
+	/** Distance above and below a promoted crowd NPC searched for the ground, in cm */
+	UPROPERTY(Config)
+	float GroundTraceDistance = 1000.0f;
+
+	/** Distance from which crowd NPCs fire at players, in cm. Zero disables crowd fire */
+	UPROPERTY(Config)
+	float FireRange = 0.0f;
+
+	/** Time between crowd NPC shots, in seconds */
+	UPROPERTY(Config)
+	float RefireTime = 1.0f;
+
+	/** Chance for a crowd NPC shot to hit */
+	UPROPERTY(Config)
+	float HitChance = 0.1f;
+
+	/** Damage dealt by a crowd NPC hit */
+	UPROPERTY(Config)
+	float HitDamage = 5.0f;
+
+	/** Entity manager the crowd lives in */
+	TSharedPtr<FMassEntityManager> EntityManager;
+
+	/** Archetype of every crowd NPC */
+	FMassArchetypeHandle Archetype;
+
+	/** Moves, fires and finds the crowd NPCs to promote */
+	FMassEntityQuery CrowdQuery;
+
+	/** Promoted actors */
+	TArray<TWeakObjectPtr<AShooterNPC>> Actors;
+
+	/** Player pawns and their locations for the current frame */
+	TArray<TWeakObjectPtr<APawn>> Players;
+	TArray<FVector> PlayerLocations;
+
+	/** Crowd NPCs to promote this frame */
+	TArray<FMassEntityHandle> PendingPromotions;
+
+	/** Hits landed by crowd NPCs this frame, per player */
+	TArray<int32> PendingHits;
+
+	/** Destinations and hits are random */
+	FRandomStream Stream;
+
+	/** Number of crowd NPCs */
+	int32 NumEntities = 0;
+
+public:
+
+	//~Begin UWorldSubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Adds crowd NPCs at random locations within a radius */
+	void SpawnCrowd(const FVector& Center, float Radius, int32 Count, uint8 TeamByte);
+
+	/** Returns the number of crowd NPCs, not counting promoted actors */
+	int32 GetNumEntities() const { return NumEntities; }
+
+	/** Returns the number of promoted actors */
+	int32 GetNumActors() const { return Actors.Num(); }
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Creates a crowd NPC */
+	void CreateEntity(const FVector& Location, float Yaw, float HP, uint8 TeamByte);
+
+	/** Returns a random point within a radius, at the center's height */
+	FVector RandomPointAround(const FVector& Center, float Radius);
+
+	/** Replaces a crowd NPC with an actor. Returns false if the actor couldn't be spawned */
+	bool Promote(FMassEntityHandle Entity);
+
+	/** Replaces an actor with a crowd NPC */
+	void Demote(AShooterNPC* NPC);
+
+	/** Demotes actors far from every player and forgets dead ones */
+	void UpdateActors();
+};
@@ -0,0 +1,254 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterEnvQueryCache.h"
+#include "ShooterAIController.h"
+#include "EnvironmentQuery/EnvQuery.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
+#include "EnvironmentQuery/EnvQueryOption.h"
+#include "EnvironmentQuery/EnvQueryGenerator.h"
+#include "EnvironmentQuery/EnvQueryTest.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "Engine/World.h"
+#include "UObject/UnrealType.h"
+
+namespace ShooterEnvQueryCache
+{
+	/**
+	 *  Returns the settings the EQS manager currently runs with
+	 *  The manager doesn't hand its config out, so its config properties are copied into the struct by name
+	 */
+	FEnvQueryManagerConfig GetCurrentConfig(const UEnvQueryManager& QueryManager)
+	{
+		FEnvQueryManagerConfig Config;
+
+		for (TFieldIterator<FProperty> It(FEnvQueryManagerConfig::StaticStruct()); It; ++It)
+		{
+			const FProperty* ManagerProperty = QueryManager.GetClass()->FindPropertyByName(It->GetFName());
+
+			if (ManagerProperty && ManagerProperty->SameType(*It))
+			{
+				It->CopyCompleteValue(It->ContainerPtrToValuePtr<void>(&Config), ManagerProperty->ContainerPtrToValuePtr<void>(&QueryManager));
+			}
+		}
+
+		return Config;
+	}
+
+	/** Returns true if any of the node's context properties is set to the querier */
+	bool UsesQuerierContext(const UObject* Node)
+	{
+		if (!Node)
+		{
+			return false;
+		}
+
+		for (TFieldIterator<FClassProperty> It(Node->GetClass()); It; ++It)
+		{
+			if (!It->MetaClass || !It->MetaClass->IsChildOf(UEnvQueryContext::StaticClass()))
+			{
+				continue;
+			}
+
+			const UClass* Context = Cast<UClass>(It->GetObjectPropertyValue_InContainer(Node));
+
+			if (Context && Context->IsChildOf(UEnvQueryContext_Querier::StaticClass()))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+bool UShooterEnvQueryCache::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterEnvQueryCache::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// cap the time queries may take each frame. Queries past the budget carry on next frame
+	if (UEnvQueryManager* QueryManager = UEnvQueryManager::GetCurrent(&InWorld))
+	{
+		FEnvQueryManagerConfig Config = ShooterEnvQueryCache::GetCurrentConfig(*QueryManager);
+		Config.MaxAllowedTestingTime = MaxQueryMillisecondsPerFrame / 1000.0f;
+
+		// step every running query a little each frame, so a single expensive query doesn't starve the rest
+		Config.bTestQueriesUsingBreadth = true;
+
+		QueryManager->Configure(Config);
+	}
+}
+
+void UShooterEnvQueryCache::Deinitialize()
+{
+	Entries.Empty();
+	QuerierDependentTemplates.Empty();
+
+	Super::Deinitialize();
+}
+
+EShooterEnvQueryStatus UShooterEnvQueryCache::RunQuery(UEnvQuery* Template, AShooterAIController* Querier, FShooterEnvQueryFinishedDelegate OnFinished, TSharedPtr<FEnvQueryResult>& OutResult)
+{
+	OutResult.Reset();
+
+	if (!Template || !Querier)
+	{
+		return EShooterEnvQueryStatus::Failed;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// NPCs without a target query around themselves, which nobody else can reuse
+	AActor* Target = Querier->GetCurrentTarget();
+
+	if (!Target)
+	{
+		Target = Querier->GetPawn() ? Cast<AActor>(Querier->GetPawn()) : Querier;
+	}
+
+	const FVector TargetLocation = Target->GetActorLocation();
+	const float TargetToleranceSquared = FMath::Square(TargetTolerance);
+
+	// querier dependent results only hold for NPCs standing about where the querier did
+	FIntVector QuerierCell = FIntVector::ZeroValue;
+
+	if (IsQuerierDependent(Template) && Querier->GetPawn())
+	{
+		const FVector Cell = Querier->GetPawn()->GetActorLocation() / FMath::Max(QuerierCellSize, 1.0f);
+		QuerierCell = FIntVector(FMath::FloorToInt32(Cell.X), FMath::FloorToInt32(Cell.Y), FMath::FloorToInt32(Cell.Z));
+	}
+
+	// drop stale results
+	Entries.RemoveAllSwap([&](const FEntry& Entry)
+	{
+		return Entry.QueryId == INDEX_NONE && (!Entry.Template.IsValid() || !Entry.Target.IsValid() || Now - Entry.StartTime > CacheDuration);
+	});
+
+	for (FEntry& Entry : Entries)
+	{
+		if (Entry.Template != Template || Entry.Target != Target || Entry.QuerierCell != QuerierCell || FVector::DistSquared(Entry.TargetLocation, TargetLocation) > TargetToleranceSquared)
+		{
+			continue;
+		}
+
+		// the same query is already running, so wait for it
+		if (Entry.QueryId != INDEX_NONE)
+		{
+			Entry.Waiting.Add(MoveTemp(OnFinished));
+			return EShooterEnvQueryStatus::Pending;
+		}
+
+		OutResult = Entry.Result;
+		return EShooterEnvQueryStatus::Cached;
+	}
+
+	// score every item, so each NPC can pick its own point out of the shared result
+	FEnvQueryRequest Request(Template, Querier);
+	const int32 QueryId = Request.Execute(EEnvQueryRunMode::AllMatching, FQueryFinishedSignature::CreateUObject(this, &UShooterEnvQueryCache::OnQueryFinished));
+
+	if (QueryId == INDEX_NONE)
+	{
+		return EShooterEnvQueryStatus::Failed;
+	}
+
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Template = Template;
+	Entry.Target = Target;
+	Entry.TargetLocation = TargetLocation;
+	Entry.QuerierCell = QuerierCell;
+	Entry.StartTime = Now;
+	Entry.QueryId = QueryId;
+	Entry.Waiting.Add(MoveTemp(OnFinished));
+
+	return EShooterEnvQueryStatus::Pending;
+}
+
+bool UShooterEnvQueryCache::IsQuerierDependent(const UEnvQuery* Template)
+{
+	if (const bool* bDependent = QuerierDependentTemplates.Find(Template))
+	{
+		return *bDependent;
+	}
+
+	bool bDependent = false;
+
+	for (const UEnvQueryOption* Option : Template->GetOptions())
+	{
+		if (!Option)
+		{
+			continue;
+		}
+
+		bDependent |= ShooterEnvQueryCache::UsesQuerierContext(Option->Generator);
+
+		for (const UEnvQueryTest* Test : Option->Tests)
+		{
+			bDependent |= ShooterEnvQueryCache::UsesQuerierContext(Test);
+		}
+	}
+
+	QuerierDependentTemplates.Add(Template, bDependent);
+	return bDependent;
+}
+
+void UShooterEnvQueryCache::OnQueryFinished(TSharedPtr<FEnvQueryResult> Result)
+{
+	const int32 EntryIndex = Entries.IndexOfByPredicate([&Result](const FEntry& Entry) { return Entry.QueryId == Result->QueryID; });
+
+	if (EntryIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// take the waiting requests out first, they may run new queries
+	TArray<FShooterEnvQueryFinishedDelegate> Waiting = MoveTemp(Entries[EntryIndex].Waiting);
+
+	// only successful results are worth reusing
+	if (Result->IsSuccessful())
+	{
+		Entries[EntryIndex].QueryId = INDEX_NONE;
+		Entries[EntryIndex].Result = Result;
+
+	} else {
+
+		Entries.RemoveAtSwap(EntryIndex);
+	}
+
+	for (const FShooterEnvQueryFinishedDelegate& Delegate : Waiting)
+	{
+		Delegate.ExecuteIfBound(Result);
+	}
+}
+
+bool UShooterEnvQueryCache::PickLocation(const FEnvQueryResult& Result, EEnvQueryRunMode::Type RunMode, FVector& OutLocation)
+{
+	// all matching results come sorted best first
+	if (Result.Items.IsEmpty())
+	{
+		return false;
+	}
+
+	int32 ItemIndex = 0;
+
+	// pick a random item out of the best ones, so NPCs sharing a result spread out
+	if (RunMode == EEnvQueryRunMode::RandomBest5Pct || RunMode == EEnvQueryRunMode::RandomBest25Pct)
+	{
+		const float MinScore = Result.GetItemScore(0) * (RunMode == EEnvQueryRunMode::RandomBest5Pct ? 0.95f : 0.75f);
+		int32 NumBest = 1;
+
+		while (NumBest < Result.Items.Num() && Result.GetItemScore(NumBest) >= MinScore)
+		{
+			++NumBest;
+		}
+
+		ItemIndex = FMath::RandRange(0, NumBest - 1);
+	}
+
+	OutLocation = Result.GetItemAsLocation(ItemIndex);
+	return true;
+}
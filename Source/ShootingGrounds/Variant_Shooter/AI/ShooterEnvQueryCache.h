@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterEnvQueryCache.generated.h"
+
+class UEnvQuery;
+class AShooterAIController;
+
+DECLARE_DELEGATE_OneParam(FShooterEnvQueryFinishedDelegate, TSharedPtr<FEnvQueryResult>);
+
+/**
+ *  Outcome of a cached query request
+ */
+enum class EShooterEnvQueryStatus : uint8
+{
+	/** A reusable result was handed out right away */
+	Cached,
+
+	/** The query is running and the request waits for it */
+	Pending,
+
+	/** The query couldn't be started. The request is dropped */
+	Failed
+};
+
+/**
+ *  Shares EQS results between NPCs querying around the same target
+ *  NPCs fighting the same player all run the same positional queries around them. Results are kept per query
+ *  template and target, and reused by any NPC asking while the target is still within a tolerance of where the
+ *  query ran, for a short time. Templates that generate or test around the querier are also kept per querier
+ *  cell, so only NPCs standing close together share them. Queries always score every item, so each NPC can still
+ *  pick its own point.
+ *  Requests for a query that's already running wait for its result instead of starting another one.
+ *  Query execution is time-sliced by the EQS manager, under the per frame budget set here
+ *  Settings live under [/Script/ShootingGrounds.ShooterEnvQueryCache] in DefaultGame.ini
+ */
+UCLASS(Config=Game)
+class SHOOTINGGROUNDS_API UShooterEnvQueryCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time a result is reused for, in seconds */
+	UPROPERTY(Config)
+	float CacheDuration = 1.0f;
+
+	/** Distance the target can move before a result is no longer reused, in cm */
+	UPROPERTY(Config)
+	float TargetTolerance = 200.0f;
+
+	/** Size of the grid cells querier dependent results are shared within, in cm */
+	UPROPERTY(Config)
+	float QuerierCellSize = 500.0f;
+
+	/** Time all running queries may take on a single frame, in milliseconds. The rest of the EQS settings are kept */
+	UPROPERTY(Config)
+	float MaxQueryMillisecondsPerFrame = 2.0f;
+
+	/** A result, or a query on its way to one */
+	struct FEntry
+	{
+		/** Query template the result is for */
+		TWeakObjectPtr<UEnvQuery> Template;
+
+		/** Actor the query ran around */
+		TWeakObjectPtr<AActor> Target;
+
+		/** Where the target was when the query ran */
+		FVector TargetLocation = FVector::ZeroVector;
+
+		/** Grid cell of the querier, for querier dependent templates only */
+		FIntVector QuerierCell = FIntVector::ZeroValue;
+
+		/** World time the query was started */
+		double StartTime = 0.0;
+
+		/** Id of the running query, or INDEX_NONE once it finished */
+		int32 QueryId = INDEX_NONE;
+
+		/** Scored items, once the query finished */
+		TSharedPtr<FEnvQueryResult> Result;
+
+		/** Requests waiting for the running query */
+		TArray<FShooterEnvQueryFinishedDelegate> Waiting;
+	};
+
+	/** Results and running queries */
+	TArray<FEntry> Entries;
+
+	/** Whether each template used so far depends on the querier's location */
+	TMap<TObjectKey<UEnvQuery>, bool> QuerierDependentTemplates;
+
+public:
+
+	//~Begin UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 *  Hands out a reusable result for the query around the NPC's current target right away, if there is one.
+	 *  Otherwise starts or joins the query and calls OnFinished once it completes. OnFinished is never called
+	 *  if the query can't be started
+	 */
+	EShooterEnvQueryStatus RunQuery(UEnvQuery* Template, AShooterAIController* Querier, FShooterEnvQueryFinishedDelegate OnFinished, TSharedPtr<FEnvQueryResult>& OutResult);
+
+	/** Picks a location from a result the way the run mode would. Returns false if the result has no items */
+	static bool PickLocation(const FEnvQueryResult& Result, EEnvQueryRunMode::Type RunMode, FVector& OutLocation);
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns true if any generator or test of the template runs around the querier */
+	bool IsQuerierDependent(const UEnvQuery* Template);
+
+	/** Stores a finished query and hands it to the requests waiting for it */
+	void OnQueryFinished(TSharedPtr<FEnvQueryResult> Result);
+};
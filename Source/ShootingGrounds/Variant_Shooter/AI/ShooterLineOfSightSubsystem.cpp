@@ -0,0 +1,247 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterLineOfSightSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "ShootingGrounds.h"
+
+void UShooterLineOfSightSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &UShooterLineOfSightSubsystem::OnTraceCompleted);
+}
+
+void UShooterLineOfSightSubsystem::Deinitialize()
+{
+	// traces still in flight complete into nothing
+	TraceDelegate.Unbind();
+
+	Entries.Empty();
+	EntryLookup.Empty();
+	PendingRequests.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UShooterLineOfSightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterLineOfSightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterLineOfSightSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterLineOfSightSubsystem::RequestLineOfSight(AActor* Viewer, const FVector& ViewLocation, AActor* Target, int32 NumChecks, FShooterLineOfSightDelegate OnResult, bool bForceRefresh)
+{
+	const TPair<FObjectKey, FObjectKey> Key(Viewer, Target);
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	const int32* FoundIndex = EntryLookup.Find(Key);
+	int32 EntryIndex = FoundIndex ? *FoundIndex : INDEX_NONE;
+
+	// new pair
+	if (EntryIndex == INDEX_NONE)
+	{
+		FShooterLineOfSightEntry NewEntry;
+		NewEntry.Viewer = Viewer;
+		NewEntry.Target = Target;
+		NewEntry.Key = Key;
+
+		EntryIndex = Entries.Add(MoveTemp(NewEntry));
+		EntryLookup.Add(Key, EntryIndex);
+	}
+
+	FShooterLineOfSightEntry& Entry = Entries[EntryIndex];
+	Entry.ViewLocation = ViewLocation;
+	Entry.NumChecks = NumChecks;
+	Entry.LastQueryTime = Now;
+
+	// a fresh result is handed out right away
+	if (!bForceRefresh && Entry.PendingTraces == 0 && !NeedsRefresh(Entry, Now))
+	{
+		OnResult.ExecuteIfBound(Entry.bHasLineOfSight);
+		return;
+	}
+
+	// otherwise wait for the refresh the next time the budget allows, or for the one in flight
+	Entry.Waiting.Add(MoveTemp(OnResult));
+}
+
+void UShooterLineOfSightSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_SCOPE_STAT(LineOfSightCache);
+
+	const int32 NumSlots = Entries.GetMaxIndex();
+
+	if (NumSlots == 0)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	int32 TraceBudget = MaxTracesPerFrame;
+	int32 EntryIndex = ScanCursor % NumSlots;
+
+	// visit every entry at most once, resuming where the budget ran out last frame
+	for (int32 Visited = 0; Visited < NumSlots && TraceBudget > 0; ++Visited, EntryIndex = (EntryIndex + 1) % NumSlots)
+	{
+		if (!Entries.IsAllocated(EntryIndex))
+		{
+			continue;
+		}
+
+		const FShooterLineOfSightEntry& Entry = Entries[EntryIndex];
+
+		// drop pairs nobody asks about anymore, or whose actors are gone
+		if ((Entry.Waiting.IsEmpty() && Now - Entry.LastQueryTime > IdleEvictionTime) || !Entry.Viewer.IsValid() || !Entry.Target.IsValid())
+		{
+			RemoveEntry(EntryIndex);
+			continue;
+		}
+
+		// only requests waiting for a result are worth tracing for
+		if (Entry.PendingTraces == 0 && !Entry.Waiting.IsEmpty())
+		{
+			// out of budget for this entry's traces, so it goes first next frame
+			if (GetNumTraces(Entry) > TraceBudget)
+			{
+				break;
+			}
+
+			TraceBudget -= StartRefresh(EntryIndex, Now);
+		}
+	}
+
+	ScanCursor = EntryIndex;
+}
+
+bool UShooterLineOfSightSubsystem::NeedsRefresh(const FShooterLineOfSightEntry& Entry, double Now) const
+{
+	if (!Entry.bHasResult || Now - Entry.LastResultTime >= MaxResultAge)
+	{
+		return true;
+	}
+
+	// small movements rarely change what's visible
+	const double ThresholdSquared = FMath::Square(MovementThreshold);
+
+	return FVector::DistSquared(Entry.ViewLocation, Entry.TracedViewLocation) > ThresholdSquared
+		|| FVector::DistSquared(Entry.Target->GetActorLocation(), Entry.TracedTargetLocation) > ThresholdSquared;
+}
+
+int32 UShooterLineOfSightSubsystem::GetNumTraces(const FShooterLineOfSightEntry& Entry) const
+{
+	// an entry asking for more checks than a frame allows gets them spread over fewer points
+	return FMath::Min(Entry.NumChecks - 1, FMath::Max(MaxTracesPerFrame, 1));
+}
+
+int32 UShooterLineOfSightSubsystem::StartRefresh(int32 EntryIndex, double Now)
+{
+	FShooterLineOfSightEntry& Entry = Entries[EntryIndex];
+	AActor* Target = Entry.Target.Get();
+
+	Entry.TracedViewLocation = Entry.ViewLocation;
+	Entry.TracedTargetLocation = Target->GetActorLocation();
+
+	// trace from the top of the target down, one trace per vertical check but the lowest
+	const int32 NumTraces = GetNumTraces(Entry);
+
+	if (NumTraces <= 0)
+	{
+		CompleteRefresh(EntryIndex, false, Now);
+		return 0;
+	}
+
+	// get the target's bounding box
+	FVector CenterOfMass, Extent;
+	Target->GetActorBounds(true, CenterOfMass, Extent, false);
+
+	// divide the vertical extent by the number of checks
+	const float ExtentZOffset = Extent.Z * 2.0f / (NumTraces + 1);
+
+	// ignore the viewer and target. We want an unobstructed trace not counting them
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterLineOfSight), false);
+	QueryParams.AddIgnoredActor(Entry.Viewer.Get());
+	QueryParams.AddIgnoredActor(Target);
+
+	// request ids tell the results apart from those of an entry that reused the slot
+	Entry.RequestId = NextRequestId++;
+	Entry.PendingTraces = NumTraces;
+	Entry.bPendingClear = false;
+	PendingRequests.Add(Entry.RequestId, EntryIndex);
+
+	for (int32 i = 0; i < NumTraces; ++i)
+	{
+		const FVector End = CenterOfMass + FVector(0.0f, 0.0f, Extent.Z - ExtentZOffset * i);
+		GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Entry.TracedViewLocation, End, ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, Entry.RequestId);
+	}
+
+	return NumTraces;
+}
+
+void UShooterLineOfSightSubsystem::CompleteRefresh(int32 EntryIndex, bool bHasLineOfSight, double Now)
+{
+	FShooterLineOfSightEntry& Entry = Entries[EntryIndex];
+	Entry.bHasLineOfSight = bHasLineOfSight;
+	Entry.bHasResult = true;
+	Entry.LastResultTime = Now;
+
+	// take the waiting requests out first, they may ask for more
+	TArray<FShooterLineOfSightDelegate> Waiting = MoveTemp(Entry.Waiting);
+
+	for (const FShooterLineOfSightDelegate& Delegate : Waiting)
+	{
+		Delegate.ExecuteIfBound(bHasLineOfSight);
+	}
+}
+
+void UShooterLineOfSightSubsystem::RemoveEntry(int32 EntryIndex)
+{
+	FShooterLineOfSightEntry& Entry = Entries[EntryIndex];
+
+	if (Entry.PendingTraces > 0)
+	{
+		PendingRequests.Remove(Entry.RequestId);
+	}
+
+	TArray<FShooterLineOfSightDelegate> Waiting = MoveTemp(Entry.Waiting);
+
+	EntryLookup.Remove(Entry.Key);
+	Entries.RemoveAt(EntryIndex);
+
+	for (const FShooterLineOfSightDelegate& Delegate : Waiting)
+	{
+		Delegate.ExecuteIfBound(false);
+	}
+}
+
+void UShooterLineOfSightSubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	// the entry may have been dropped while the trace was in flight
+	const int32* FoundIndex = PendingRequests.Find(Datum.UserData);
+
+	if (!FoundIndex)
+	{
+		return;
+	}
+
+	const int32 EntryIndex = *FoundIndex;
+	FShooterLineOfSightEntry& Entry = Entries[EntryIndex];
+
+	// one unobstructed trace is enough
+	if (!Datum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; }))
+	{
+		Entry.bPendingClear = true;
+	}
+
+	if (--Entry.PendingTraces == 0)
+	{
+		PendingRequests.Remove(Datum.UserData);
+
+		CompleteRefresh(EntryIndex, Entry.bPendingClear, GetWorld()->GetTimeSeconds());
+	}
+}
@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterLineOfSightSubsystem.generated.h"
+
+DECLARE_DELEGATE_OneParam(FShooterLineOfSightDelegate, bool);
+
+/**
+ *  Cached line of sight between a viewer and a target
+ */
+struct FShooterLineOfSightEntry
+{
+	/** Actor looking */
+	TWeakObjectPtr<AActor> Viewer;
+
+	/** Actor being looked at */
+	TWeakObjectPtr<AActor> Target;
+
+	/** Key of the entry in the lookup map */
+	TPair<FObjectKey, FObjectKey> Key;
+
+	/** Where the viewer last looked from, as passed by the latest request */
+	FVector ViewLocation = FVector::ZeroVector;
+
+	/** Viewer and target locations the cached result was traced from */
+	FVector TracedViewLocation = FVector::ZeroVector;
+	FVector TracedTargetLocation = FVector::ZeroVector;
+
+	/** Number of vertically offset points on the target to trace to */
+	int32 NumChecks = 1;
+
+	/** World time of the latest request and the latest result */
+	double LastQueryTime = 0.0;
+	double LastResultTime = 0.0;
+
+	/** Traces still in flight for the current refresh, and the request they belong to */
+	int32 PendingTraces = 0;
+	uint32 RequestId = 0;
+
+	/** True if any trace of the current refresh made it through */
+	bool bPendingClear = false;
+
+	/** True once the first refresh completed */
+	bool bHasResult = false;
+
+	/** Cached result */
+	bool bHasLineOfSight = false;
+
+	/** Requests waiting for the next refresh */
+	TArray<FShooterLineOfSightDelegate> Waiting;
+};
+
+/**
+ *  World level line of sight cache
+ *  Requests get the cached result right away while it's fresh. Otherwise they wait for the entry's next refresh,
+ *  which the subsystem runs with async traces under a per frame trace budget. A result goes stale when it's too old
+ *  or its viewer or target moved too far. Only entries with waiting requests get traced, so the trace cost follows
+ *  the perception updates asking for line of sight and is capped by the budget
+ *  Settings live under [/Script/ShootingGrounds.ShooterLineOfSightSubsystem] in DefaultGame.ini
+ */
+UCLASS(Config=Game)
+class SHOOTINGGROUNDS_API UShooterLineOfSightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Maximum number of traces started per frame */
+	UPROPERTY(Config)
+	int32 MaxTracesPerFrame = 16;
+
+	/** Age after which a result gets refreshed even if nothing moved, in seconds */
+	UPROPERTY(Config)
+	float MaxResultAge = 0.5f;
+
+	/** Distance the viewer or target can move before the result gets refreshed, in cm */
+	UPROPERTY(Config)
+	float MovementThreshold = 50.0f;
+
+	/** Entries that weren't requested for this long are dropped, in seconds */
+	UPROPERTY(Config)
+	float IdleEvictionTime = 2.0f;
+
+	/** Cached entries. Indices stay stable while entries come and go */
+	TSparseArray<FShooterLineOfSightEntry> Entries;
+
+	/** Finds the entry for a viewer and target pair */
+	TMap<TPair<FObjectKey, FObjectKey>, int32> EntryLookup;
+
+	/** Entry each refresh request in flight belongs to */
+	TMap<uint32, int32> PendingRequests;
+
+	/** Called by the async traces as they complete */
+	FTraceDelegate TraceDelegate;
+
+	/** Entry to resume the refresh scan from on the next frame */
+	int32 ScanCursor = 0;
+
+	/** Source of refresh request ids */
+	uint32 NextRequestId = 1;
+
+public:
+
+	//~Begin UWorldSubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/**
+	 *  Asks for the line of sight from the viewer to any of NumChecks vertically spread points on the target
+	 *  Calls OnResult right away if the cached result is fresh, otherwise once the next refresh completes.
+	 *  Forced requests always wait for a refresh, for callers that know the cached result no longer holds.
+	 *  Requests dropped along with their entry get no line of sight
+	 */
+	void RequestLineOfSight(AActor* Viewer, const FVector& ViewLocation, AActor* Target, int32 NumChecks, FShooterLineOfSightDelegate OnResult, bool bForceRefresh = false);
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Returns true if an entry's result is missing, too old or traced from positions that moved too far */
+	bool NeedsRefresh(const FShooterLineOfSightEntry& Entry, double Now) const;
+
+	/** Returns the number of traces a refresh of the entry starts, never more than a frame's budget */
+	int32 GetNumTraces(const FShooterLineOfSightEntry& Entry) const;
+
+	/** Starts the async traces for an entry. Returns the number of traces started */
+	int32 StartRefresh(int32 EntryIndex, double Now);
+
+	/** Stores a refresh result and hands it to the waiting requests */
+	void CompleteRefresh(int32 EntryIndex, bool bHasLineOfSight, double Now);
+
+	/** Removes an entry, forgets its traces in flight and fails its waiting requests */
+	void RemoveEntry(int32 EntryIndex);
+
+	/** Collects an async trace result into its entry */
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+};
@@ -8,14 +8,25 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "ShooterGameMode.h"
+#include "ShooterAIController.h"
+#include "ShooterNPCSignificance.h"
+#include "ShooterRagdollBudget.h"
+#include "ShooterAITags.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "ShootingGrounds.h"
 
 void AShooterNPC::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// scale our update rates with our significance to the players
+	if (UShooterNPCSignificance* Significance = GetWorld()->GetSubsystem<UShooterNPCSignificance>())
+	{
+		Significance->RegisterNPC(this);
+	}
+
 	// spawn the weapon
 	FActorSpawnParameters SpawnParams;
 	SpawnParams.Owner = this;
@@ -23,12 +34,28 @@ void AShooterNPC::BeginPlay()
 	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
 	Weapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+
+	// remember how the mesh sits on the capsule, so a pooled NPC can get up again after a ragdoll death
+	MeshRelativeTransform = GetMesh()->GetRelativeTransform();
+	MeshCollisionProfile = GetMesh()->GetCollisionProfileName();
+	CapsuleCollision = GetCapsuleComponent()->GetCollisionEnabled();
 }
 
 void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
+	if (UShooterNPCSignificance* Significance = GetWorld()->GetSubsystem<UShooterNPCSignificance>())
+	{
+		Significance->UnregisterNPC(this);
+	}
+
+	// free our ragdoll slot
+	if (UShooterRagdollBudget* RagdollBudget = GetWorld()->GetSubsystem<UShooterRagdollBudget>())
+	{
+		RagdollBudget->ReleaseRagdoll(this);
+	}
+
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
 }
@@ -48,6 +75,14 @@ float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEve
 	if (CurrentHP <= 0.0f)
 	{
 		Die();
+
+	} else {
+
+		// let the StateTree react to the hit
+		if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+		{
+			AIController->SendAIEvent(ShooterAITags::Damaged);
+		}
 	}
 
 	return Damage;
@@ -82,6 +117,8 @@ void AShooterNPC::UpdateWeaponHUD(int32 CurrentAmmo, int32 MagazineSize)
 
 FVector AShooterNPC::GetWeaponTargetLocation()
 {
+	SHOOTER_SCOPE_STAT(NPCAim);
+
 	// start aiming from the camera location
 	const FVector AimSource = GetFirstPersonCameraComponent()->GetComponentLocation();
 
@@ -159,6 +196,12 @@ void AShooterNPC::Die()
 	// raise the dead flag
 	bIsDead = true;
 
+	// dead NPCs don't need ranking, and the ragdoll looks best at full rate
+	if (UShooterNPCSignificance* Significance = GetWorld()->GetSubsystem<UShooterNPCSignificance>())
+	{
+		Significance->UnregisterNPC(this);
+	}
+
 	// increment the team score
 	if (AShooterGameMode* GM = Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()))
 	{
@@ -172,10 +215,27 @@ void AShooterNPC::Die()
 	GetCharacterMovement()->StopMovementImmediately();
 	GetCharacterMovement()->StopActiveMovement();
 
-	// enable ragdoll physics on the third person mesh
-	GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
-	GetMesh()->SetSimulatePhysics(true);
-	GetMesh()->SetPhysicsBlendWeight(1.0f);
+	// ragdoll if there's room in the budget, otherwise fall back to the death animation
+	UShooterRagdollBudget* RagdollBudget = GetWorld()->GetSubsystem<UShooterRagdollBudget>();
+
+	if (!RagdollBudget || RagdollBudget->RequestRagdoll(this))
+	{
+		// enable ragdoll physics on the third person mesh
+		GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
+		GetMesh()->SetSimulatePhysics(true);
+		GetMesh()->SetPhysicsBlendWeight(1.0f);
+
+	} else {
+
+		// without a death animation, just hold the current pose
+		if (!DeathMontage || PlayAnimMontage(DeathMontage) <= 0.0f)
+		{
+			GetMesh()->bNoSkeletonUpdate = true;
+		}
+	}
+
+	// notify the controller
+	OnPawnDeath.Broadcast();
 
 	// schedule actor destruction
 	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, DeferredDestructionTime, false);
@@ -183,9 +243,125 @@ void AShooterNPC::Die()
 
 void AShooterNPC::DeferredDestruction()
 {
+	// pooled NPCs go back to their pool instead
+	if (IsPooled())
+	{
+		DeactivateNPC();
+		OnReleased.Execute(this);
+		return;
+	}
+
 	Destroy();
 }
 
+void AShooterNPC::FreezeRagdoll()
+{
+	// stop updating the bones first, so the mesh keeps the simulated pose
+	GetMesh()->bNoSkeletonUpdate = true;
+
+	// take the bodies out of the simulation
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+void AShooterNPC::ResetRagdoll()
+{
+	// give up our ragdoll slot if we still hold one
+	if (UShooterRagdollBudget* RagdollBudget = GetWorld()->GetSubsystem<UShooterRagdollBudget>())
+	{
+		RagdollBudget->ReleaseRagdoll(this);
+	}
+
+	// stop the death animation, if we played it
+	StopAnimMontage(DeathMontage);
+
+	// stop simulating and put the mesh back where it was on the capsule
+	GetMesh()->bNoSkeletonUpdate = false;
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->SetCollisionProfileName(MeshCollisionProfile);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	GetMesh()->SetRelativeTransform(MeshRelativeTransform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// restore capsule collision
+	GetCapsuleComponent()->SetCollisionEnabled(CapsuleCollision);
+}
+
+void AShooterNPC::ActivateNPC(const FVector& Location, const FRotator& Rotation)
+{
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+
+	// back to full health
+	CurrentHP = GetDefault<AShooterNPC>(GetClass())->CurrentHP;
+	bIsDead = false;
+
+	bIsDormant = false;
+
+	// back into the world
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	GetMesh()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	if (Weapon)
+	{
+		Weapon->SetActorHiddenInGame(false);
+	}
+
+	if (UShooterNPCSignificance* Significance = GetWorld()->GetSubsystem<UShooterNPCSignificance>())
+	{
+		Significance->RegisterNPC(this);
+	}
+
+	// restart the StateTree from the top
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->ResumeLogic();
+	}
+}
+
+void AShooterNPC::DeactivateNPC()
+{
+	bIsDormant = true;
+
+	if (UShooterNPCSignificance* Significance = GetWorld()->GetSubsystem<UShooterNPCSignificance>())
+	{
+		Significance->UnregisterNPC(this);
+	}
+
+	// stop the AI. Dead NPCs already had it stopped by their controller
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->SuspendLogic();
+	}
+
+	// stop shooting and forget the aim target
+	bIsShooting = false;
+	CurrentAimTarget = nullptr;
+
+	if (Weapon)
+	{
+		Weapon->StopFiring();
+		Weapon->SetActorHiddenInGame(true);
+	}
+
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	ResetRagdoll();
+
+	// out of the world until the next activation
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	GetMesh()->SetComponentTickEnabled(false);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
+
 void AShooterNPC::StartShooting(AActor* ActorToShoot)
 {
 	// save the aim target
@@ -206,3 +382,14 @@ void AShooterNPC::StopShooting()
 	// signal the weapon
 	Weapon->StopFiring();
 }
+
+bool AShooterNPC::IsInCombat() const
+{
+	if (bIsShooting)
+	{
+		return true;
+	}
+
+	const AShooterAIController* AIController = Cast<AShooterAIController>(GetController());
+	return AIController && AIController->GetCurrentTarget();
+}
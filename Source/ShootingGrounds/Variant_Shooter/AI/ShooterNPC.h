@@ -10,6 +10,9 @@
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPawnDeathDelegate);
 
 class AShooterWeapon;
+class AShooterNPC;
+
+DECLARE_DELEGATE_OneParam(FShooterNPCReleasedDelegate, AShooterNPC*);
 
 /**
  *  A simple AI-controlled shooter game NPC
@@ -33,6 +36,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName RagdollCollisionProfile = FName("Ragdoll");
 
+	/** Death animation played instead of the ragdoll when too many ragdolls are simulating. Should hold its last pose */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	TObjectPtr<UAnimMontage> DeathMontage;
+
 	/** Time to wait after death before destroying this actor */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	float DeferredDestructionTime = 5.0f;
@@ -84,11 +91,22 @@ protected:
 	/** Deferred destruction on death timer */
 	FTimerHandle DeathTimer;
 
+	/** If true, this character is waiting in a pool to be activated */
+	bool bIsDormant = false;
+
+	/** Mesh placement and collision to restore after a ragdoll death */
+	FTransform MeshRelativeTransform;
+	FName MeshCollisionProfile;
+	ECollisionEnabled::Type CapsuleCollision = ECollisionEnabled::QueryAndPhysics;
+
 public:
 
 	/** Delegate called when this NPC dies */
 	FPawnDeathDelegate OnPawnDeath;
 
+	/** If bound, called instead of destroying this NPC after death. Pooled NPCs go back to their pool through it */
+	FShooterNPCReleasedDelegate OnReleased;
+
 protected:
 
 	/** Gameplay initialization */
@@ -143,11 +161,41 @@ protected:
 	/** Called after death to destroy the actor */
 	void DeferredDestruction();
 
+	/** Takes the mesh out of ragdoll and puts it back on the capsule */
+	void ResetRagdoll();
+
 public:
 
+	/** Stops simulating the ragdoll and holds its current pose */
+	void FreezeRagdoll();
+
 	/** Signals this character to start shooting at the passed actor */
 	void StartShooting(AActor* ActorToShoot);
 
 	/** Signals this character to stop shooting */
 	void StopShooting();
+
+	/** Returns true if this character is shooting or has a target to shoot at */
+	bool IsInCombat() const;
+
+	/** Returns true if this character has died */
+	bool IsDead() const { return bIsDead; }
+
+	/** Returns true if this character goes back to a pool instead of being destroyed */
+	bool IsPooled() const { return OnReleased.IsBound(); }
+
+	/** Returns true while this NPC waits in its pool */
+	bool IsDormant() const { return bIsDormant; }
+
+	/** Brings a pooled character back into play at full HP, and restarts its AI */
+	void ActivateNPC(const FVector& Location, const FRotator& Rotation);
+
+	/** Takes this character out of play until it's activated again. Hidden, without collision and with its AI stopped */
+	void DeactivateNPC();
+
+	/** Sets the team this character scores for */
+	void SetTeamByte(uint8 InTeamByte) { TeamByte = InTeamByte; }
+
+	/** Returns the team this character scores for */
+	uint8 GetTeamByte() const { return TeamByte; }
 };
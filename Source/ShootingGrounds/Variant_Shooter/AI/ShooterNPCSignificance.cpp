@@ -0,0 +1,218 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterNPCSignificance.h"
+#include "ShooterNPC.h"
+#include "ShooterAIController.h"
+#include "SignificanceManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "ShootingGrounds.h"
+
+namespace ShooterNPCSignificance
+{
+	/** Tag the NPCs are registered under with the significance manager */
+	const FName Tag = FName("ShooterNPC");
+}
+
+UShooterNPCSignificance::UShooterNPCSignificance()
+{
+	// nearby or fighting NPCs run at full rate, the rest progressively slower
+	FShooterNPCLODLevel& High = Levels.AddDefaulted_GetRef();
+	High.MinSignificance = 0.5f;
+	High.MaxNPCs = 16;
+
+	FShooterNPCLODLevel& Medium = Levels.AddDefaulted_GetRef();
+	Medium.MinSignificance = 0.2f;
+	Medium.MaxNPCs = 64;
+	Medium.StateTreeTickInterval = 0.1f;
+	Medium.PerceptionInterval = 0.1f;
+	Medium.MovementTickInterval = 1.0f / 30.0f;
+	Medium.AnimationTickInterval = 1.0f / 30.0f;
+
+	FShooterNPCLODLevel& Low = Levels.AddDefaulted_GetRef();
+	Low.StateTreeTickInterval = 0.25f;
+	Low.PerceptionInterval = 0.25f;
+	Low.MovementTickInterval = 0.1f;
+	Low.AnimationTickInterval = 0.2f;
+	Low.bOnlyAnimateWhenRendered = true;
+}
+
+void UShooterNPCSignificance::Deinitialize()
+{
+	// the significance functions point back at us
+	if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		SignificanceManager->UnregisterAll(ShooterNPCSignificance::Tag);
+	}
+
+	NPCLevels.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UShooterNPCSignificance::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterNPCSignificance::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterNPCSignificance, STATGROUP_Tickables);
+}
+
+void UShooterNPCSignificance::RegisterNPC(AShooterNPC* NPC)
+{
+	USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld());
+
+	if (!SignificanceManager || Levels.IsEmpty())
+	{
+		return;
+	}
+
+	// the first update applies the NPC's level
+	NPCLevels.Add(NPC, INDEX_NONE);
+
+	SignificanceManager->RegisterObject(NPC, ShooterNPCSignificance::Tag,
+		[this](USignificanceManager::FManagedObjectInfo* Info, const FTransform& Viewpoint)
+		{
+			return CalculateSignificance(static_cast<const AShooterNPC*>(Info->GetObject()), Viewpoint);
+		}
+	);
+}
+
+void UShooterNPCSignificance::UnregisterNPC(AShooterNPC* NPC)
+{
+	if (NPCLevels.Remove(NPC) == 0)
+	{
+		return;
+	}
+
+	if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		SignificanceManager->UnregisterObject(NPC);
+	}
+
+	// back to full rate
+	ApplyLevel(NPC, FShooterNPCLODLevel());
+}
+
+int32 UShooterNPCSignificance::GetNPCLevel(const AShooterNPC* NPC) const
+{
+	const int32* Level = NPCLevels.Find(NPC);
+	return Level ? *Level : INDEX_NONE;
+}
+
+void UShooterNPCSignificance::Tick(float DeltaTime)
+{
+	if (NPCLevels.IsEmpty())
+	{
+		return;
+	}
+
+	SHOOTER_SCOPE_STAT(NPCSignificance);
+
+	USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld());
+
+	if (!SignificanceManager)
+	{
+		return;
+	}
+
+	// score against every player, simulated ones included. The manager keeps the highest score per NPC
+	Viewpoints.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			Viewpoints.Emplace(ViewRotation, ViewLocation);
+		}
+	}
+
+	// nobody to rank against, so keep the current levels
+	if (Viewpoints.IsEmpty())
+	{
+		return;
+	}
+
+	SignificanceManager->Update(Viewpoints);
+
+	// the managed objects come back sorted, most significant first. Levels fill up in that order
+	LevelCounts.Init(0, Levels.Num());
+
+	for (const USignificanceManager::FManagedObjectInfo* Info : SignificanceManager->GetManagedObjects(ShooterNPCSignificance::Tag))
+	{
+		AShooterNPC* NPC = static_cast<AShooterNPC*>(Info->GetObject());
+		int32* CurrentLevel = NPCLevels.Find(NPC);
+
+		if (!CurrentLevel)
+		{
+			continue;
+		}
+
+		// take the most detailed level the NPC qualifies for, or the last one
+		int32 NewLevel = Levels.Num() - 1;
+
+		for (int32 i = 0; i < Levels.Num() - 1; ++i)
+		{
+			if (Info->GetSignificance() >= Levels[i].MinSignificance && (Levels[i].MaxNPCs <= 0 || LevelCounts[i] < Levels[i].MaxNPCs))
+			{
+				NewLevel = i;
+				break;
+			}
+		}
+
+		++LevelCounts[NewLevel];
+
+		// only touch the components when the level changes
+		if (NewLevel != *CurrentLevel)
+		{
+			*CurrentLevel = NewLevel;
+			ApplyLevel(NPC, Levels[NewLevel]);
+		}
+	}
+}
+
+float UShooterNPCSignificance::CalculateSignificance(const AShooterNPC* NPC, const FTransform& Viewpoint) const
+{
+	// halves at the reference distance and keeps falling off from there
+	const float Distance = FVector::Dist(NPC->GetActorLocation(), Viewpoint.GetLocation());
+	float Significance = HalfSignificanceDistance / (HalfSignificanceDistance + Distance);
+
+	// NPCs off screen can get away with more
+	if (!NPC->WasRecentlyRendered(RecentlyRenderedTime))
+	{
+		Significance *= OffScreenScale;
+	}
+
+	// NPCs in a fight need to react quickly wherever they are
+	if (NPC->IsInCombat())
+	{
+		Significance += CombatBonus;
+	}
+
+	return Significance;
+}
+
+void UShooterNPCSignificance::ApplyLevel(AShooterNPC* NPC, const FShooterNPCLODLevel& Level) const
+{
+	NPC->GetCharacterMovement()->SetComponentTickInterval(Level.MovementTickInterval);
+
+	NPC->GetMesh()->SetComponentTickInterval(Level.AnimationTickInterval);
+	NPC->GetMesh()->VisibilityBasedAnimTickOption = Level.bOnlyAnimateWhenRendered ? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered : EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	NPC->GetFirstPersonMesh()->SetComponentTickInterval(Level.AnimationTickInterval);
+
+	// the controller runs the StateTree and the perception
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(NPC->GetController()))
+	{
+		AIController->SetUpdateIntervals(Level.StateTreeTickInterval, Level.PerceptionInterval);
+	}
+}
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNPCSignificance.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Update rates for a level of detail. A tick interval of zero ticks every frame
+ */
+USTRUCT()
+struct FShooterNPCLODLevel
+{
+	GENERATED_BODY()
+
+	/** Lowest significance for this level */
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	float MinSignificance = 0.0f;
+
+	/** Most NPCs allowed at this level, taken in significance order. Zero is unlimited */
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	int32 MaxNPCs = 0;
+
+	/** Tick interval of the StateTree, in seconds */
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	float StateTreeTickInterval = 0.0f;
+
+	/** Interval between perception batches handed to the StateTree, in seconds */
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	float PerceptionInterval = 0.0f;
+
+	/** Tick interval of the character movement, in seconds */
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	float MovementTickInterval = 0.0f;
+
+	/** Tick interval of the skeletal meshes, in seconds */
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	float AnimationTickInterval = 0.0f;
+
+	/** If true, poses are only updated while the mesh is on screen */
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	bool bOnlyAnimateWhenRendered = false;
+};
+
+/**
+ *  Scales the NPC update rates with their significance to the players
+ *  NPCs are registered with the engine significance manager, which scores them every frame against every
+ *  player viewpoint by distance, whether they were recently on screen and whether they're fighting, and ranks them.
+ *  Each NPC then gets the first level its significance and rank qualify for, and its StateTree, perception,
+ *  movement and animation are slowed down to that level's rates. Rates only change when the level does
+ *  Levels and weights live under [/Script/ShootingGrounds.ShooterNPCSignificance] in DefaultGame.ini
+ */
+UCLASS(Config=Game)
+class SHOOTINGGROUNDS_API UShooterNPCSignificance : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Levels from the most to the least detailed. NPCs that qualify for none get the last one */
+	UPROPERTY(Config)
+	TArray<FShooterNPCLODLevel> Levels;
+
+	/** Distance at which distance alone halves the significance, in cm */
+	UPROPERTY(Config)
+	float HalfSignificanceDistance = 2000.0f;
+
+	/** Significance multiplier for NPCs that weren't on screen recently */
+	UPROPERTY(Config)
+	float OffScreenScale = 0.5f;
+
+	/** Significance added while an NPC is fighting */
+	UPROPERTY(Config)
+	float CombatBonus = 0.5f;
+
+	/** Time an NPC counts as on screen after it was last rendered, in seconds */
+	UPROPERTY(Config)
+	float RecentlyRenderedTime = 0.5f;
+
+	/** Current level of each registered NPC */
+	TMap<TObjectKey<AShooterNPC>, int32> NPCLevels;
+
+	/** Player viewpoints for the current update */
+	TArray<FTransform> Viewpoints;
+
+	/** Number of NPCs assigned to each level on the current update */
+	TArray<int32> LevelCounts;
+
+public:
+
+	/** Constructor */
+	UShooterNPCSignificance();
+
+	//~Begin UWorldSubsystem interface
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Starts managing an NPC's update rates */
+	void RegisterNPC(AShooterNPC* NPC);
+
+	/** Stops managing an NPC and restores its full update rates */
+	void UnregisterNPC(AShooterNPC* NPC);
+
+	/** Returns the level of detail an NPC is at, or INDEX_NONE if it isn't managed */
+	int32 GetNPCLevel(const AShooterNPC* NPC) const;
+
+	/** Returns the number of NPCs being managed, which are the living NPCs in play */
+	int32 GetNumNPCs() const { return NPCLevels.Num(); }
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Scores an NPC against a viewpoint. Runs on worker threads */
+	float CalculateSignificance(const AShooterNPC* NPC, const FTransform& Viewpoint) const;
+
+	/** Applies a level's update rates to an NPC */
+	void ApplyLevel(AShooterNPC* NPC, const FShooterNPCLODLevel& Level) const;
+};
@@ -0,0 +1,185 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterNPCWaveSpawner.h"
+#include "ShooterNPC.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "ShootingGrounds.h"
+
+AShooterNPCWaveSpawner::AShooterNPCWaveSpawner()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// create the root
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+}
+
+void AShooterNPCWaveSpawner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// NPCs are spawned by the server
+	if (GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	if (!NPCClass)
+	{
+		UE_LOG(LogShootingGrounds, Warning, TEXT("%s: NPCClass is not set, no waves will be spawned"), *GetName());
+		return;
+	}
+
+	// fill the pool up front, so the waves themselves don't spawn anything
+	NPCPool.Reserve(WaveSize);
+	ActiveNPCs.Reserve(WaveSize);
+
+	while (NPCPool.Num() < WaveSize)
+	{
+		AShooterNPC* NPC = CreateNPC();
+
+		if (!NPC)
+		{
+			break;
+		}
+
+		NPCPool.Add(NPC);
+	}
+
+	SpawnWave();
+}
+
+void AShooterNPCWaveSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	GetWorld()->GetTimerManager().ClearTimer(WaveTimer);
+
+	// spawners removed during play take their NPCs with them
+	if (EndPlayReason == EEndPlayReason::Destroyed)
+	{
+		NPCPool.Append(ActiveNPCs);
+		ActiveNPCs.Reset();
+
+		for (AShooterNPC* NPC : NPCPool)
+		{
+			if (IsValid(NPC))
+			{
+				NPC->OnDestroyed.RemoveDynamic(this, &AShooterNPCWaveSpawner::HandleNPCDestroyed);
+				NPC->OnReleased.Unbind();
+
+				if (AController* Controller = NPC->GetController())
+				{
+					Controller->Destroy();
+				}
+
+				NPC->Destroy();
+			}
+		}
+
+		NPCPool.Reset();
+	}
+}
+
+void AShooterNPCWaveSpawner::SpawnWave()
+{
+	++WavesSpawned;
+
+	for (int32 i = 0; i < WaveSize; ++i)
+	{
+		AShooterNPC* NPC = AcquireNPC();
+
+		if (!NPC)
+		{
+			break;
+		}
+
+		// uniform over the disc around the spawner
+		const float Angle = FMath::FRandRange(0.0f, UE_TWO_PI);
+		const float Distance = SpawnRadius * FMath::Sqrt(FMath::FRand());
+		const FVector Location = GetActorLocation() + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.0f);
+
+		NPC->ActivateNPC(Location, FRotator(0.0f, FMath::FRandRange(-180.0f, 180.0f), 0.0f));
+		ActiveNPCs.Add(NPC);
+	}
+}
+
+AShooterNPC* AShooterNPCWaveSpawner::AcquireNPC()
+{
+	// reuse a pooled NPC if we have one
+	if (NPCPool.Num() > 0)
+	{
+		return NPCPool.Pop(EAllowShrinking::No);
+	}
+
+	return CreateNPC();
+}
+
+AShooterNPC* AShooterNPCWaveSpawner::CreateNPC()
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AShooterNPC* NPC = GetWorld()->SpawnActor<AShooterNPC>(NPCClass, GetActorLocation(), GetActorRotation(), SpawnParams);
+
+	if (!NPC)
+	{
+		return nullptr;
+	}
+
+	// spawned pawns only get their AI controller if the class asks for it
+	if (!NPC->GetController())
+	{
+		NPC->SpawnDefaultController();
+	}
+
+	// deaths return the NPC to the pool instead of destroying it
+	NPC->OnReleased.BindUObject(this, &AShooterNPCWaveSpawner::HandleNPCReleased);
+
+	// forget the NPC if something else destroys it
+	NPC->OnDestroyed.AddDynamic(this, &AShooterNPCWaveSpawner::HandleNPCDestroyed);
+
+	// wait for a wave
+	NPC->DeactivateNPC();
+
+	return NPC;
+}
+
+void AShooterNPCWaveSpawner::HandleNPCReleased(AShooterNPC* NPC)
+{
+	ActiveNPCs.RemoveSwap(NPC, EAllowShrinking::No);
+	NPCPool.Add(NPC);
+
+	// start the next wave once the current one is cleared
+	if (ActiveNPCs.IsEmpty())
+	{
+		ScheduleNextWave();
+	}
+}
+
+void AShooterNPCWaveSpawner::HandleNPCDestroyed(AActor* DestroyedActor)
+{
+	AShooterNPC* NPC = Cast<AShooterNPC>(DestroyedActor);
+
+	NPCPool.RemoveSwap(NPC, EAllowShrinking::No);
+
+	// a destroyed NPC may have been the last one standing
+	if (ActiveNPCs.RemoveSwap(NPC, EAllowShrinking::No) > 0 && ActiveNPCs.IsEmpty())
+	{
+		ScheduleNextWave();
+	}
+}
+
+void AShooterNPCWaveSpawner::ScheduleNextWave()
+{
+	// are we out of waves?
+	if (NumWaves > 0 && WavesSpawned >= NumWaves)
+	{
+		return;
+	}
+
+	GetWorld()->GetTimerManager().SetTimer(WaveTimer, this, &AShooterNPCWaveSpawner::SpawnWave, FMath::Max(TimeBetweenWaves, UE_KINDA_SMALL_NUMBER), false);
+}
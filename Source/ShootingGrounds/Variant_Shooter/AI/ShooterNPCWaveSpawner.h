@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ShooterNPCWaveSpawner.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Spawns waves of NPCs around itself, reusing the same NPCs for every wave
+ *  Each pooled NPC keeps its AI controller and weapon for its whole lifetime. When an NPC dies, its ragdoll
+ *  plays out as usual, then it's put back together, hidden and returned to the pool instead of being destroyed.
+ *  The next wave starts once the last NPC of the current one is back in the pool.
+ *  The pool is filled when play begins, so waves don't spawn any actors once it's big enough for a full wave
+ */
+UCLASS()
+class SHOOTINGGROUNDS_API AShooterNPCWaveSpawner : public AActor
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Type of NPC to spawn */
+	UPROPERTY(EditAnywhere, Category="Spawning")
+	TSubclassOf<AShooterNPC> NPCClass;
+
+	/** Number of NPCs in each wave */
+	UPROPERTY(EditAnywhere, Category="Spawning", meta = (ClampMin = 1, ClampMax = 256))
+	int32 WaveSize = 8;
+
+	/** Number of waves to spawn. Zero keeps spawning waves for as long as the spawner is around */
+	UPROPERTY(EditAnywhere, Category="Spawning", meta = (ClampMin = 0))
+	int32 NumWaves = 0;
+
+	/** Time between the end of a wave and the start of the next one */
+	UPROPERTY(EditAnywhere, Category="Spawning", meta = (ClampMin = 0, Units = "s"))
+	float TimeBetweenWaves = 5.0f;
+
+	/** Radius around the spawner NPCs are placed in */
+	UPROPERTY(EditAnywhere, Category="Spawning", meta = (ClampMin = 0, Units = "cm"))
+	float SpawnRadius = 1000.0f;
+
+	/** NPCs currently in play */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShooterNPC>> ActiveNPCs;
+
+	/** Dormant NPCs waiting for the next wave */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShooterNPC>> NPCPool;
+
+	/** Timer for the next wave */
+	FTimerHandle WaveTimer;
+
+	/** Number of waves spawned so far */
+	int32 WavesSpawned = 0;
+
+public:
+
+	/** Constructor */
+	AShooterNPCWaveSpawner();
+
+protected:
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Brings up a full wave of NPCs */
+	void SpawnWave();
+
+	/** Starts the timer for the next wave, unless we're out of waves */
+	void ScheduleNextWave();
+
+	/** Returns a dormant NPC from the pool, or spawns a new one if the pool is empty */
+	AShooterNPC* AcquireNPC();
+
+	/** Spawns a new NPC with its controller, and makes it dormant */
+	AShooterNPC* CreateNPC();
+
+	/** Returns an NPC to the pool after its death, and schedules the next wave once the current one is done */
+	void HandleNPCReleased(AShooterNPC* NPC);
+
+	/** Forgets an NPC destroyed by something else */
+	UFUNCTION()
+	void HandleNPCDestroyed(AActor* DestroyedActor);
+
+public:
+
+	/** Returns the number of NPCs in play */
+	int32 GetNumActiveNPCs() const { return ActiveNPCs.Num(); }
+
+	/** Returns the number of dormant NPCs in the pool */
+	int32 GetNumPooledNPCs() const { return NPCPool.Num(); }
+};
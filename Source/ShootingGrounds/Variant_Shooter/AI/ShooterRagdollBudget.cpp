@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterRagdollBudget.h"
+#include "ShooterNPC.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "ShootingGrounds.h"
+
+bool UShooterRagdollBudget::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterRagdollBudget::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterRagdollBudget, STATGROUP_Tickables);
+}
+
+bool UShooterRagdollBudget::RequestRagdoll(AShooterNPC* NPC)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	Ragdolls.RemoveAll([](const FShooterActiveRagdoll& Ragdoll) { return !Ragdoll.NPC.IsValid(); });
+
+	// out of slots, so freeze the oldest ragdoll if it's been falling long enough
+	if (Ragdolls.Num() >= MaxSimulatingRagdolls)
+	{
+		if (Ragdolls.IsEmpty() || Now - Ragdolls[0].StartTime < MinSimulationTime)
+		{
+			return false;
+		}
+
+		Ragdolls[0].NPC->FreezeRagdoll();
+		Ragdolls.RemoveAt(0, EAllowShrinking::No);
+	}
+
+	FShooterActiveRagdoll& Ragdoll = Ragdolls.AddDefaulted_GetRef();
+	Ragdoll.NPC = NPC;
+	Ragdoll.StartTime = Now;
+
+	return true;
+}
+
+void UShooterRagdollBudget::ReleaseRagdoll(AShooterNPC* NPC)
+{
+	Ragdolls.RemoveAll([NPC](const FShooterActiveRagdoll& Ragdoll) { return Ragdoll.NPC == NPC; });
+}
+
+void UShooterRagdollBudget::Tick(float DeltaTime)
+{
+	if (Ragdolls.IsEmpty())
+	{
+		return;
+	}
+
+	SHOOTER_SCOPE_STAT(RagdollBudget);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float SettleSpeedSquared = FMath::Square(SettleSpeed);
+
+	// freeze settled ragdolls, oldest first
+	for (int32 i = 0; i < Ragdolls.Num(); ++i)
+	{
+		AShooterNPC* NPC = Ragdolls[i].NPC.Get();
+
+		if (!NPC)
+		{
+			Ragdolls.RemoveAt(i--, EAllowShrinking::No);
+			continue;
+		}
+
+		const double SimulationTime = Now - Ragdolls[i].StartTime;
+
+		// the newer ragdolls haven't been falling long enough either
+		if (SimulationTime < MinSimulationTime)
+		{
+			break;
+		}
+
+		if (SimulationTime >= MaxSimulationTime || NPC->GetMesh()->GetPhysicsLinearVelocity().SizeSquared() <= SettleSpeedSquared)
+		{
+			NPC->FreezeRagdoll();
+			Ragdolls.RemoveAt(i--, EAllowShrinking::No);
+		}
+	}
+}
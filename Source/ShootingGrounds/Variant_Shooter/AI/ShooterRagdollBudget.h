@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterRagdollBudget.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  A ragdoll being simulated
+ */
+struct FShooterActiveRagdoll
+{
+	/** NPC the ragdoll belongs to */
+	TWeakObjectPtr<AShooterNPC> NPC;
+
+	/** World time the simulation started */
+	double StartTime = 0.0;
+};
+
+/**
+ *  Caps the number of NPC ragdolls simulating at once
+ *  Dying NPCs ask for a ragdoll slot. Ragdolls that come to rest are frozen in their last pose, oldest first,
+ *  which takes their bodies out of the physics scene. When every slot is taken, the oldest ragdoll that has been
+ *  falling for a while is frozen early to make room. If none can, the NPC plays its death animation instead,
+ *  so a mass kill never has more than the capped number of ragdolls simulating
+ *  Settings live under [/Script/ShootingGrounds.ShooterRagdollBudget] in DefaultGame.ini
+ */
+UCLASS(Config=Game)
+class SHOOTINGGROUNDS_API UShooterRagdollBudget : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Most ragdolls simulating at once */
+	UPROPERTY(Config)
+	int32 MaxSimulatingRagdolls = 8;
+
+	/** Root body speed under which a ragdoll counts as settled, in cm/s */
+	UPROPERTY(Config)
+	float SettleSpeed = 10.0f;
+
+	/** Time a ragdoll simulates before it can be frozen, in seconds */
+	UPROPERTY(Config)
+	float MinSimulationTime = 1.0f;
+
+	/** Time after which a ragdoll is frozen even if it hasn't settled, in seconds */
+	UPROPERTY(Config)
+	float MaxSimulationTime = 5.0f;
+
+	/** Simulating ragdolls, oldest first */
+	TArray<FShooterActiveRagdoll> Ragdolls;
+
+public:
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Returns true if the NPC may ragdoll, freezing an older ragdoll to make room if needed */
+	bool RequestRagdoll(AShooterNPC* NPC);
+
+	/** Gives up an NPC's ragdoll slot without freezing it */
+	void ReleaseRagdoll(AShooterNPC* NPC);
+
+	/** Returns the number of ragdolls simulating */
+	int32 GetNumSimulating() const { return Ragdolls.Num(); }
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterStateTreeAIComponent.h"
+#include "ShootingGrounds.h"
+
+void UShooterStateTreeAIComponent::ResetTickStats()
+{
+	NumTicks = 0;
+	TickMilliseconds = 0.0;
+}
+
+void UShooterStateTreeAIComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	SHOOTER_SCOPE_STAT(NPCStateTree);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	++NumTicks;
+	TickMilliseconds += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+}
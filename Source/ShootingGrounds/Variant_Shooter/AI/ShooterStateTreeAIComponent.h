@@ -0,0 +1,45 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/StateTreeAIComponent.h"
+#include "ShooterStateTreeAIComponent.generated.h"
+
+/**
+ *  StateTree AI component that keeps count of its own ticks
+ *  Every NPC's tick count and tick time show in its controller's details panel while playing in the editor,
+ *  so an NPC whose tree should be asleep but keeps ticking stands out. The ticks also add up under the
+ *  NPCStateTree perf scope for the whole world
+ */
+UCLASS(ClassGroup=(Shooter))
+class SHOOTINGGROUNDS_API UShooterStateTreeAIComponent : public UStateTreeAIComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of times this StateTree ticked */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="Stats")
+	int32 NumTicks = 0;
+
+	/** Time spent ticking this StateTree, in milliseconds */
+	UPROPERTY(VisibleInstanceOnly, Transient, Category="Stats")
+	double TickMilliseconds = 0.0;
+
+public:
+
+	/** Returns the number of times this StateTree ticked */
+	int32 GetNumTicks() const { return NumTicks; }
+
+	/** Returns the time spent ticking this StateTree, in milliseconds */
+	double GetTickMilliseconds() const { return TickMilliseconds; }
+
+	/** Starts counting over */
+	void ResetTickStats();
+
+protected:
+
+	/** Ticks the StateTree and counts the tick */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+};
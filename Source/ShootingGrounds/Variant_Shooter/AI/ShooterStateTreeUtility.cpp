@@ -8,10 +8,17 @@
 #include "AIController.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "ShooterAIController.h"
+#include "ShooterLineOfSightSubsystem.h"
+#include "ShooterEnvQueryCache.h"
+#include "ShooterAITags.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "Engine/World.h"
+#include "ShootingGrounds.h"
 
 bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
+	SHOOTER_SCOPE_STAT(LineOfSight);
+
 	const FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
 	// ensure the target is valid
@@ -32,41 +39,18 @@ bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionCo
 		return !InstanceData.bMustHaveLineOfSight;
 	}
 
-	// get the target's bounding box
-	FVector CenterOfMass, Extent;
-	InstanceData.Target->GetActorBounds(true, CenterOfMass, Extent, false);
-
-	// divide the vertical extent by the number of line of sight checks we'll do
-	const float ExtentZOffset = Extent.Z * 2.0f / InstanceData.NumberOfVerticalLineOfSightChecks;
-
-	// get the character's camera location as the source for the line checks
-	const FVector Start = InstanceData.Character->GetFirstPersonCameraComponent()->GetComponentLocation();
-
-	// ignore the character and target. We want to ensure there's an unobstructed trace not counting them
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(InstanceData.Character);
-	QueryParams.AddIgnoredActor(InstanceData.Target);
+	// read the line of sight found on the latest perception update, and keep it from going stale while we're asking.
+	// Changes to it arrive as PerceptionUpdated events
+	AShooterAIController* Controller = Cast<AShooterAIController>(InstanceData.Character->GetController());
 
-	FHitResult OutHit;
-
-	// run a number of vertically offset line traces to the target location
-	for (int32 i = 0; i < InstanceData.NumberOfVerticalLineOfSightChecks - 1; ++i)
+	if (Controller)
 	{
-		// calculate the endpoint for the trace
-		const FVector End = CenterOfMass + FVector(0.0f, 0.0f, Extent.Z - ExtentZOffset * i);
-
-		InstanceData.Character->GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
-
-		// is the trace unobstructed?
-		if (!OutHit.bBlockingHit)
-		{
-			// we only need one unobstructed trace, so terminate early
-			return InstanceData.bMustHaveLineOfSight;
-		}
+		Controller->RefreshLineOfSight(InstanceData.Target);
 	}
 
-	// no line of sight found
-	return !InstanceData.bMustHaveLineOfSight;
+	const bool bHasLineOfSight = Controller && Controller->HasLineOfSightTo(InstanceData.Target);
+
+	return bHasLineOfSight == InstanceData.bMustHaveLineOfSight;
 }
 
 #if WITH_EDITOR
@@ -211,6 +195,93 @@ FText FStateTreeShootAtTargetTask::GetDescription(const FGuid& ID, FStateTreeDat
 }
 #endif // WITH_EDITOR
 
+namespace ShooterSenseEnemies
+{
+	/** Sensed actor waiting on its line of sight check */
+	struct FEntry
+	{
+		/** Actor that caused the stimulus */
+		TWeakObjectPtr<AActor> Actor;
+
+		/** Strongest stimulus from the actor this frame */
+		FAIStimulus Stimulus;
+
+		/** True if the stimulus came from within the perception cone, so its line of sight gets checked */
+		bool bInCone = false;
+
+		/** True if the actor is in line of sight */
+		bool bDirectLOS = false;
+
+		/** True if the team reported the actor. Its last known location is newer than anything we heard */
+		bool bTeamSighting = false;
+
+		/** False if the newest stimulus reported the actor lost, so its line of sight is traced again instead of read from the cache */
+		bool bSensed = true;
+	};
+
+	/** Stimuli processed together, shared by their line of sight checks */
+	struct FBatch
+	{
+		/** Sensed actors, in the order they were sensed */
+		TArray<FEntry> Entries;
+
+		/** Line of sight checks still waiting for their result */
+		int32 PendingChecks = 0;
+	};
+
+	/** Updates the task outputs from a batch, in the order the stimuli were sensed */
+	void ApplyBatch(FStateTreeSenseEnemiesInstanceData& InstanceData, const FBatch& Batch)
+	{
+		for (const FEntry& Entry : Batch.Entries)
+		{
+			AActor* SensedActor = Entry.Actor.Get();
+
+			// the actor may have been destroyed while its line of sight was checked
+			if (!SensedActor)
+			{
+				continue;
+			}
+
+			// keep the line of sight for the conditions, so they don't need to trace
+			InstanceData.Controller->SetLineOfSight(SensedActor, Entry.bDirectLOS, InstanceData.NumberOfVerticalLineOfSightChecks);
+
+			// check if we have a direct line of sight to the stimulus
+			if (Entry.bDirectLOS)
+			{
+				// set the controller's target
+				InstanceData.Controller->SetCurrentTarget(SensedActor);
+
+				// set the task output
+				InstanceData.TargetActor = SensedActor;
+
+				// set the flags
+				InstanceData.bHasTarget = true;
+				InstanceData.bHasInvestigateLocation = false;
+
+			// no direct line of sight to target
+			} else {
+
+				// if we already have a target, ignore the partial sense and keep on them
+				if (!IsValid(InstanceData.TargetActor))
+				{
+					// is this stimulus stronger than the last one we had? The team's reports keep moving the location along
+					if (Entry.Stimulus.Strength > InstanceData.LastStimulusStrength || (Entry.bTeamSighting && Entry.Stimulus.Strength >= InstanceData.LastStimulusStrength))
+					{
+						// update the stimulus strength
+						InstanceData.LastStimulusStrength = Entry.Stimulus.Strength;
+
+						// set the investigate location
+						InstanceData.InvestigateLocation = Entry.Stimulus.StimulusLocation;
+
+						// set the investigate flag
+						InstanceData.bHasInvestigateLocation = true;
+					}
+				}
+			}
+		}
+	}
+}
+
 EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
 	// have we transitioned from another state?
@@ -219,75 +290,111 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-		// bind the perception updated delegate on the controller
+		// bind the perception updated delegate on the controller. The controller batches the updates once per frame
 		InstanceData.Controller->OnShooterPerceptionUpdated.BindLambda(
-			[WeakContext = Context.MakeWeakExecutionContext()](AActor* SensedActor, const FAIStimulus& Stimulus)
+			[WeakContext = Context.MakeWeakExecutionContext()](const TArray<FShooterSensedStimulus>& SensedStimuli)
 			{
+				SHOOTER_SCOPE_STAT(SenseEnemies);
+
 				// get the instance data inside the lambda
 				const FStateTreeStrongExecutionContext StrongContext = WeakContext.MakeStrongExecutionContext();
+				FInstanceDataType* LambdaInstanceData = StrongContext.GetInstanceDataPtr<FInstanceDataType>();
 
-				if (FInstanceDataType* LambdaInstanceData = StrongContext.GetInstanceDataPtr<FInstanceDataType>())
+				if (!LambdaInstanceData || !IsValid(LambdaInstanceData->Character))
 				{
-					if (SensedActor->ActorHasTag(LambdaInstanceData->SenseTag))
+					return;
+				}
+
+				const FVector CharacterLocation = LambdaInstanceData->Character->GetActorLocation();
+				const FVector CharacterForward = LambdaInstanceData->Character->GetActorForwardVector();
+				const float MaxDot = FMath::Cos(FMath::DegreesToRadians(LambdaInstanceData->DirectLineOfSightCone));
+
+				const TSharedRef<ShooterSenseEnemies::FBatch> Batch = MakeShared<ShooterSenseEnemies::FBatch>();
+
+				for (const FShooterSensedStimulus& Sensed : SensedStimuli)
+				{
+					AActor* SensedActor = Sensed.Actor.Get();
+
+					if (!SensedActor || !SensedActor->ActorHasTag(LambdaInstanceData->SenseTag))
 					{
-						bool bDirectLOS = false;
+						continue;
+					}
 
-						// calculate the direction of the stimulus
-						const FVector StimulusDir = (Stimulus.StimulusLocation - LambdaInstanceData->Character->GetActorLocation()).GetSafeNormal();
+					ShooterSenseEnemies::FEntry& Entry = Batch->Entries.AddDefaulted_GetRef();
+					Entry.Actor = SensedActor;
+					Entry.Stimulus = Sensed.Stimulus;
 
-						// infer the angle from the dot product between the character facing and the stimulus direction
-						const float DirDot = FVector::DotProduct(StimulusDir, LambdaInstanceData->Character->GetActorForwardVector());
-						const float MaxDot = FMath::Cos(FMath::DegreesToRadians(LambdaInstanceData->DirectLineOfSightCone));
+					// the team only tells us where to look. We still need our own line of sight to take the actor on
+					Entry.bTeamSighting = Sensed.bTeamSighting;
+					Entry.bSensed = Sensed.bSensed;
 
-						// is the direction within our perception cone?
-						if (DirDot >= MaxDot)
-						{
-							// run a line trace between the character and the sensed actor
-							FCollisionQueryParams QueryParams;
-							QueryParams.AddIgnoredActor(LambdaInstanceData->Character);
-							QueryParams.AddIgnoredActor(SensedActor);
+					// calculate the direction of the stimulus
+					const FVector StimulusDir = (Sensed.Stimulus.StimulusLocation - CharacterLocation).GetSafeNormal();
 
-							FHitResult OutHit;
+					// infer the angle from the dot product between the character facing and the stimulus direction.
+					// Only stimuli within our perception cone need a line of sight check
+					Entry.bInCone = FVector::DotProduct(StimulusDir, CharacterForward) >= MaxDot;
 
-							// we have direct line of sight if this trace is unobstructed
-							bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_Visibility, QueryParams);
+					if (Entry.bInCone)
+					{
+						++Batch->PendingChecks;
+					}
+				}
 
-						}
+				// nothing to check, so the batch can be applied right away
+				if (Batch->PendingChecks == 0)
+				{
+					ShooterSenseEnemies::ApplyBatch(*LambdaInstanceData, *Batch);
+					LambdaInstanceData->Controller->SendAIEvent(ShooterAITags::PerceptionUpdated);
+					return;
+				}
 
-						// check if we have a direct line of sight to the stimulus
-						if (bDirectLOS)
-						{
-							// set the controller's target
-							LambdaInstanceData->Controller->SetCurrentTarget(SensedActor);
+				// the line of sight cache hands out fresh results right away and traces stale ones under its budget
+				UShooterLineOfSightSubsystem* LineOfSight = LambdaInstanceData->Character->GetWorld()->GetSubsystem<UShooterLineOfSightSubsystem>();
+
+				if (!LineOfSight)
+				{
+					ShooterSenseEnemies::ApplyBatch(*LambdaInstanceData, *Batch);
+					LambdaInstanceData->Controller->SendAIEvent(ShooterAITags::PerceptionUpdated);
+					return;
+				}
 
-							// set the task output
-							LambdaInstanceData->TargetActor = SensedActor;
+				// look from the character's camera
+				const FVector ViewLocation = LambdaInstanceData->Character->GetFirstPersonCameraComponent()->GetComponentLocation();
 
-							// set the flags
-							LambdaInstanceData->bHasTarget = true;
-							LambdaInstanceData->bHasInvestigateLocation = false;
+				// ask for the line of sight to each sensed actor in the cone. The batch is applied once the last one is in
+				for (int32 i = 0; i < Batch->Entries.Num(); ++i)
+				{
+					const ShooterSenseEnemies::FEntry& Entry = Batch->Entries[i];
 
-						// no direct line of sight to target
-						} else {
+					if (!Entry.bInCone)
+					{
+						continue;
+					}
+
+					// a lost actor may still look visible to the cache, so trace it again
+					const bool bForceRefresh = !Entry.bSensed;
+
+					LineOfSight->RequestLineOfSight(LambdaInstanceData->Character, ViewLocation, Entry.Actor.Get(), LambdaInstanceData->NumberOfVerticalLineOfSightChecks, FShooterLineOfSightDelegate::CreateLambda(
+						[WeakContext, Batch, i](bool bHasLineOfSight)
+						{
+							Batch->Entries[i].bDirectLOS = bHasLineOfSight;
 
-							// if we already have a target, ignore the partial sense and keep on them
-							if (!IsValid(LambdaInstanceData->TargetActor))
+							if (--Batch->PendingChecks > 0)
 							{
-								// is this stimulus stronger than the last one we had?
-								if (Stimulus.Strength > LambdaInstanceData->LastStimulusStrength)
-								{
-									// update the stimulus strength
-									LambdaInstanceData->LastStimulusStrength = Stimulus.Strength;
-
-									// set the investigate location
-									LambdaInstanceData->InvestigateLocation = Stimulus.StimulusLocation;
-
-									// set the investigate flag
-									LambdaInstanceData->bHasInvestigateLocation = true;
-								}
+								return;
+							}
+
+							// the state may have been left while the checks were pending
+							const FStateTreeStrongExecutionContext CheckContext = WeakContext.MakeStrongExecutionContext();
+
+							if (FInstanceDataType* CheckInstanceData = CheckContext.GetInstanceDataPtr<FInstanceDataType>())
+							{
+								ShooterSenseEnemies::ApplyBatch(*CheckInstanceData, *Batch);
+								CheckInstanceData->Controller->SendAIEvent(ShooterAITags::PerceptionUpdated);
 							}
 						}
-					}
+					), bForceRefresh);
 				}
 			}
 		);
@@ -335,6 +442,8 @@ EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionCo
 					// clear the target on the controller
 					LambdaInstanceData->Controller->ClearCurrentTarget();
 					LambdaInstanceData->Controller->ClearFocus(EAIFocusPriority::Gameplay);
+
+					LambdaInstanceData->Controller->SendAIEvent(ShooterAITags::PerceptionForgotten);
 				}
 
 			}
@@ -363,4 +472,54 @@ FText FStateTreeSenseEnemiesTask::GetDescription(const FGuid& ID, FStateTreeData
 {
 	return FText::FromString("<b>Sense Enemies</b>");
 }
-#endif // WITH_EDITOR
\ No newline at end of file
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreeCachedEnvQueryTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	UShooterEnvQueryCache* QueryCache = InstanceData.Controller ? InstanceData.Controller->GetWorld()->GetSubsystem<UShooterEnvQueryCache>() : nullptr;
+
+	if (!QueryCache)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// finish the task once the query completes
+	TSharedPtr<FEnvQueryResult> CachedResult;
+	const EShooterEnvQueryStatus Status = QueryCache->RunQuery(InstanceData.QueryTemplate, InstanceData.Controller, FShooterEnvQueryFinishedDelegate::CreateLambda(
+		[WeakContext = Context.MakeWeakExecutionContext()](TSharedPtr<FEnvQueryResult> Result)
+		{
+			// the state may have been left while the query was running
+			const FStateTreeStrongExecutionContext StrongContext = WeakContext.MakeStrongExecutionContext();
+			FInstanceDataType* LambdaInstanceData = StrongContext.GetInstanceDataPtr<FInstanceDataType>();
+
+			if (!LambdaInstanceData)
+			{
+				return;
+			}
+
+			const bool bPicked = Result.IsValid() && Result->IsSuccessful() && UShooterEnvQueryCache::PickLocation(*Result, LambdaInstanceData->RunMode, LambdaInstanceData->ResultLocation);
+			WeakContext.FinishTask(bPicked ? EStateTreeFinishTaskType::Succeeded : EStateTreeFinishTaskType::Failed);
+		}
+	), CachedResult);
+
+	// another NPC ran this query recently, so we can use its result right away
+	if (Status == EShooterEnvQueryStatus::Cached)
+	{
+		return CachedResult.IsValid() && UShooterEnvQueryCache::PickLocation(*CachedResult, InstanceData.RunMode, InstanceData.ResultLocation) ? EStateTreeRunStatus::Succeeded : EStateTreeRunStatus::Failed;
+	}
+
+	// nothing will finish the task if the query never started
+	return Status == EShooterEnvQueryStatus::Pending ? EStateTreeRunStatus::Running : EStateTreeRunStatus::Failed;
+}
+
+#if WITH_EDITOR
+FText FStateTreeCachedEnvQueryTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Run Cached Env Query</b>");
+}
+#endif // WITH_EDITOR
@@ -5,12 +5,14 @@
 #include "CoreMinimal.h"
 #include "StateTreeTaskBase.h"
 #include "StateTreeConditionBase.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
 
 #include "ShooterStateTreeUtility.generated.h"
 
 class AShooterNPC;
 class AAIController;
 class AShooterAIController;
+class UEnvQuery;
 
 /**
  *  Instance data struct for the FStateTreeLineOfSightToTargetCondition condition
@@ -32,10 +34,6 @@ struct FStateTreeLineOfSightToTargetConditionInstanceData
 	UPROPERTY(EditAnywhere, Category = "Condition")
 	float LineOfSightConeAngle = 35.0f;
 
-	/** Number of vertical line of sight checks to run to try and get around low obstacles */
-	UPROPERTY(EditAnywhere, Category = "Condition")
-	int32 NumberOfVerticalLineOfSightChecks = 5;
-
 	/** If true, the condition passes if the character has line of sight */
 	UPROPERTY(EditAnywhere, Category = "Condition")
 	bool bMustHaveLineOfSight = true;
@@ -43,7 +41,10 @@ struct FStateTreeLineOfSightToTargetConditionInstanceData
 STATETREE_POD_INSTANCEDATA(FStateTreeLineOfSightToTargetConditionInstanceData);
 
 /**
- *  StateTree condition to check if the character is grounded
+ *  StateTree condition to check if the character has line of sight to the target
+ *  Reads the line of sight the Sense Enemies task found on the latest perception update instead of tracing.
+ *  Values past the controller's max age count as no line of sight. Testing the condition has them refreshed
+ *  through the line of sight cache before they get there, so they're kept up while the state is active
  */
 USTRUCT(DisplayName = "Has Line of Sight to Target", Category="Shooter")
 struct FStateTreeLineOfSightToTargetCondition : public FStateTreeConditionCommonBase
@@ -94,6 +95,9 @@ struct FStateTreeFaceActorTask : public FStateTreeTaskCommonBase
 {
 	GENERATED_BODY()
 
+	/** Constructor. The task only reacts to state changes and events, so the tree doesn't need to tick for it */
+	FStateTreeFaceActorTask() { bShouldCallTick = false; }
+
 	/* Ensure we're using the correct instance data struct */
 	using FInstanceDataType = FStateTreeFaceActorInstanceData;
 	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
@@ -136,6 +140,9 @@ struct FStateTreeFaceLocationTask : public FStateTreeTaskCommonBase
 {
 	GENERATED_BODY()
 
+	/** Constructor */
+	FStateTreeFaceLocationTask() { bShouldCallTick = false; }
+
 	/* Ensure we're using the correct instance data struct */
 	using FInstanceDataType = FStateTreeFaceLocationInstanceData;
 	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
@@ -182,6 +189,9 @@ struct FStateTreeSetRandomFloatTask : public FStateTreeTaskCommonBase
 {
 	GENERATED_BODY()
 
+	/** Constructor */
+	FStateTreeSetRandomFloatTask() { bShouldCallTick = false; }
+
 	/* Ensure we're using the correct instance data struct */
 	using FInstanceDataType = FStateTreeSetRandomFloatData;
 	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
@@ -221,6 +231,9 @@ struct FStateTreeShootAtTargetTask : public FStateTreeTaskCommonBase
 {
 	GENERATED_BODY()
 
+	/** Constructor */
+	FStateTreeShootAtTargetTask() { bShouldCallTick = false; }
+
 	/* Ensure we're using the correct instance data struct */
 	using FInstanceDataType = FStateTreeShootAtTargetInstanceData;
 	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
@@ -278,6 +291,10 @@ struct FStateTreeSenseEnemiesInstanceData
 	UPROPERTY(EditAnywhere, Category = Parameter)
 	float DirectLineOfSightCone = 85.0f;
 
+	/** Number of vertical line of sight checks to run to try and get around low obstacles */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	int32 NumberOfVerticalLineOfSightChecks = 5;
+
 	/** Strength of the last processed stimulus */
 	UPROPERTY(EditAnywhere)
 	float LastStimulusStrength = 0.0f;
@@ -291,6 +308,9 @@ struct FStateTreeSenseEnemiesTask : public FStateTreeTaskCommonBase
 {
 	GENERATED_BODY()
 
+	/** Constructor */
+	FStateTreeSenseEnemiesTask() { bShouldCallTick = false; }
+
 	/* Ensure we're using the correct instance data struct */
 	using FInstanceDataType = FStateTreeSenseEnemiesInstanceData;
 	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
@@ -306,4 +326,54 @@ struct FStateTreeSenseEnemiesTask : public FStateTreeTaskCommonBase
 #endif // WITH_EDITOR
 };
 
-////////////////////////////////////////////////////////////////////
\ No newline at end of file
+////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Run Cached Env Query StateTree task
+ */
+USTRUCT()
+struct FStateTreeCachedEnvQueryInstanceData
+{
+	GENERATED_BODY()
+
+	/** Querying AI Controller */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AShooterAIController> Controller;
+
+	/** Query to run */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TObjectPtr<UEnvQuery> QueryTemplate;
+
+	/** How to pick the result location out of the scored items */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TEnumAsByte<EEnvQueryRunMode::Type> RunMode = EEnvQueryRunMode::RandomBest25Pct;
+
+	/** Picked location */
+	UPROPERTY(EditAnywhere, Category = Output)
+	FVector ResultLocation = FVector::ZeroVector;
+};
+
+/**
+ *  StateTree task to run an EQS query through the shared query cache
+ *  NPCs running the same query around the same target reuse each other's results
+ */
+USTRUCT(meta=(DisplayName="Run Cached Env Query", Category="Shooter"))
+struct FStateTreeCachedEnvQueryTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/** Constructor */
+	FStateTreeCachedEnvQueryTask() { bShouldCallTick = false; }
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeCachedEnvQueryInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
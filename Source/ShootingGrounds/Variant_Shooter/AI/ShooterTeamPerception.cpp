@@ -0,0 +1,210 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterTeamPerception.h"
+#include "ShooterAIController.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "ShootingGrounds.h"
+
+bool UShooterTeamPerception::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterTeamPerception::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterTeamPerception, STATGROUP_Tickables);
+}
+
+void UShooterTeamPerception::RegisterMember(FName TeamTag, AShooterAIController* Member)
+{
+	Teams.FindOrAdd(TeamTag).Members.AddUnique(Member);
+}
+
+void UShooterTeamPerception::UnregisterMember(FName TeamTag, AShooterAIController* Member)
+{
+	if (FShooterTeamPerceptionState* Team = Teams.Find(TeamTag))
+	{
+		Team->Members.Remove(Member);
+	}
+}
+
+const TArray<FShooterKnownEnemy>* UShooterTeamPerception::GetKnownEnemies(FName TeamTag) const
+{
+	const FShooterTeamPerceptionState* Team = Teams.Find(TeamTag);
+	return Team ? &Team->KnownEnemies : nullptr;
+}
+
+void UShooterTeamPerception::Tick(float DeltaTime)
+{
+	if (Teams.IsEmpty())
+	{
+		return;
+	}
+
+	// enemies out of sight fade from memory until they're forgotten
+	for (auto TeamIt = Teams.CreateIterator(); TeamIt; ++TeamIt)
+	{
+		FShooterTeamPerceptionState& Team = TeamIt.Value();
+		Team.Members.RemoveAll([](const TWeakObjectPtr<AShooterAIController>& Member) { return !Member.IsValid() || !Member->GetPawn(); });
+
+		if (Team.Members.IsEmpty())
+		{
+			TeamIt.RemoveCurrent();
+			continue;
+		}
+
+		for (int32 i = Team.KnownEnemies.Num() - 1; i >= 0; --i)
+		{
+			FShooterKnownEnemy& Known = Team.KnownEnemies[i];
+
+			if (!Known.bVisible)
+			{
+				Known.Confidence = FMath::Max(0.0f, Known.Confidence - DeltaTime / MemoryDuration);
+			}
+
+			if (Known.Confidence <= 0.0f || !Known.Enemy.IsValid())
+			{
+				for (const TWeakObjectPtr<AShooterAIController>& Member : Team.Members)
+				{
+					Member->ForgetTeamSighting(Known.Enemy.Get());
+				}
+
+				Team.KnownEnemies.RemoveAtSwap(i);
+			}
+		}
+	}
+
+	TimeSinceUpdate += DeltaTime;
+
+	if (TimeSinceUpdate < UpdateInterval)
+	{
+		return;
+	}
+
+	TimeSinceUpdate = 0.0f;
+
+	SHOOTER_SCOPE_STAT(TeamPerception);
+
+	// the enemies are the tagged player pawns
+	Enemies.Reset();
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr;
+
+		if (Pawn && Pawn->ActorHasTag(EnemyTag))
+		{
+			Enemies.Add(Pawn);
+		}
+	}
+
+	for (TPair<FName, FShooterTeamPerceptionState>& Team : Teams)
+	{
+		UpdateTeam(Team.Value);
+	}
+}
+
+void UShooterTeamPerception::UpdateTeam(FShooterTeamPerceptionState& Team)
+{
+	const float SightRadiusSquared = FMath::Square(SightRadius);
+	const float MinDot = FMath::Cos(FMath::DegreesToRadians(SightHalfAngle));
+
+	for (AActor* Enemy : Enemies)
+	{
+		FShooterKnownEnemy* Known = Team.KnownEnemies.FindByPredicate([Enemy](const FShooterKnownEnemy& Candidate) { return Candidate.Enemy == Enemy; });
+		const FVector EnemyLocation = Enemy->GetActorLocation();
+
+		// teammates in range with the enemy in their view cone, closest first
+		Lookouts.Reset();
+
+		for (const TWeakObjectPtr<AShooterAIController>& Member : Team.Members)
+		{
+			const APawn* Pawn = Member->GetPawn();
+			const FVector ToEnemy = EnemyLocation - Pawn->GetActorLocation();
+			const float DistanceSquared = ToEnemy.SizeSquared();
+
+			if (DistanceSquared <= SightRadiusSquared && FVector::DotProduct(ToEnemy.GetSafeNormal(), Pawn->GetActorForwardVector()) >= MinDot)
+			{
+				Lookouts.Emplace(DistanceSquared, Member.Get());
+			}
+		}
+
+		Lookouts.Sort([](const TPair<float, AShooterAIController*>& A, const TPair<float, AShooterAIController*>& B) { return A.Key < B.Key; });
+
+		// a single trace per enemy. After a failed look the next teammate in line gets a go
+		AShooterAIController* Spotter = nullptr;
+		bool bSeen = false;
+
+		if (!Lookouts.IsEmpty())
+		{
+			Spotter = Lookouts[(Known ? Known->FailedLooks : 0) % Lookouts.Num()].Value;
+			bSeen = CanSee(Spotter, Enemy);
+		}
+
+		if (!bSeen)
+		{
+			if (Known)
+			{
+				Known->Spotter = Spotter;
+				Known->FailedLooks += Spotter ? 1 : 0;
+
+				// tell the team the enemy went out of sight, so they move on to its last known location
+				if (Known->bVisible)
+				{
+					Known->bVisible = false;
+
+					for (const TWeakObjectPtr<AShooterAIController>& Member : Team.Members)
+					{
+						Member->QueueTeamSighting(Enemy, Known->LastKnownLocation, Known->Confidence, false);
+					}
+				}
+			}
+
+			continue;
+		}
+
+		if (!Known)
+		{
+			Known = &Team.KnownEnemies.AddDefaulted_GetRef();
+			Known->Enemy = Enemy;
+		}
+
+		// only news is worth a stimulus: the enemy came into sight or moved away from where the team thinks it is
+		const bool bShare = !Known->bVisible || FVector::DistSquared(Known->SharedLocation, EnemyLocation) > FMath::Square(ShareDistance);
+
+		Known->LastKnownLocation = EnemyLocation;
+		Known->Confidence = 1.0f;
+		Known->LastSeenTime = GetWorld()->GetTimeSeconds();
+		Known->Spotter = Spotter;
+		Known->FailedLooks = 0;
+		Known->bVisible = true;
+
+		if (!bShare)
+		{
+			continue;
+		}
+
+		Known->SharedLocation = EnemyLocation;
+
+		// what one teammate sees, the whole team sees
+		for (const TWeakObjectPtr<AShooterAIController>& Member : Team.Members)
+		{
+			Member->QueueTeamSighting(Enemy, EnemyLocation, 1.0f, true);
+		}
+	}
+}
+
+bool UShooterTeamPerception::CanSee(const AShooterAIController* Member, const AActor* Enemy) const
+{
+	const APawn* Pawn = Member->GetPawn();
+
+	// ignore the teammate and the enemy. We want an unobstructed trace not counting them
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterTeamPerception), false);
+	QueryParams.AddIgnoredActor(Pawn);
+	QueryParams.AddIgnoredActor(Enemy);
+
+	return !GetWorld()->LineTraceTestByChannel(Pawn->GetPawnViewLocation(), Enemy->GetActorLocation(), ECC_Visibility, QueryParams);
+}
@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterTeamPerception.generated.h"
+
+class AShooterAIController;
+
+/**
+ *  What a team knows about an enemy
+ */
+struct FShooterKnownEnemy
+{
+	/** Enemy actor */
+	TWeakObjectPtr<AActor> Enemy;
+
+	/** Where the enemy was last seen */
+	FVector LastKnownLocation = FVector::ZeroVector;
+
+	/** Location last handed to the teammates */
+	FVector SharedLocation = FVector::ZeroVector;
+
+	/** How sure the team is about the enemy, from 1 while seen down to 0 when forgotten */
+	float Confidence = 0.0f;
+
+	/** World time the enemy was last seen */
+	double LastSeenTime = 0.0;
+
+	/** Teammate that looked for the enemy on the last update */
+	TWeakObjectPtr<AShooterAIController> Spotter;
+
+	/** Number of failed looks since the enemy was last seen. Picks the next teammate to look */
+	int32 FailedLooks = 0;
+
+	/** True if a teammate saw the enemy on the last update */
+	bool bVisible = false;
+};
+
+/**
+ *  Sight shared by every NPC on a team
+ */
+struct FShooterTeamPerceptionState
+{
+	/** Controllers of the NPCs on the team */
+	TArray<TWeakObjectPtr<AShooterAIController>> Members;
+
+	/** Enemies the team knows about */
+	TArray<FShooterKnownEnemy> KnownEnemies;
+};
+
+/**
+ *  Per team sight for the NPCs
+ *  Instead of every NPC running its own sight sense against every player, each team looks for each enemy once per
+ *  update, from the closest teammate that has the enemy in its view cone. What the team sees goes into a shared
+ *  list of known enemies with their last known location and a confidence that fades once they're out of sight,
+ *  and is handed to every teammate's Sense Enemies task through the regular perception batch when an enemy comes
+ *  into or goes out of sight, or moves far enough from the location the team was last told about.
+ *  A team sighting only gives teammates a location to investigate. Teammates take an enemy on as their target
+ *  after their own line of sight check, which only those with the enemy in their view cone run, so sight traces
+ *  scale with the NPCs facing an enemy instead of with every NPC on the team. Hearing stays per NPC
+ *  Settings live under [/Script/ShootingGrounds.ShooterTeamPerception] in DefaultGame.ini
+ */
+UCLASS(Config=Game)
+class SHOOTINGGROUNDS_API UShooterTeamPerception : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** If true, NPCs turn their own sight sense off when they join a team */
+	UPROPERTY(Config)
+	bool bReplaceNPCSight = true;
+
+	/** Tag actors need to be looked for */
+	UPROPERTY(Config)
+	FName EnemyTag = FName("Player");
+
+	/** Time between sight updates, in seconds */
+	UPROPERTY(Config)
+	float UpdateInterval = 0.1f;
+
+	/** Max distance a teammate can see an enemy from, in cm */
+	UPROPERTY(Config)
+	float SightRadius = 3000.0f;
+
+	/** Half angle of a teammate's view cone, in degrees */
+	UPROPERTY(Config)
+	float SightHalfAngle = 85.0f;
+
+	/** Time an enemy out of sight takes to be forgotten, in seconds */
+	UPROPERTY(Config)
+	float MemoryDuration = 5.0f;
+
+	/** Distance a visible enemy has to move before teammates are told its new location, in cm */
+	UPROPERTY(Config)
+	float ShareDistance = 200.0f;
+
+	/** Shared state of each team, by team tag */
+	TMap<FName, FShooterTeamPerceptionState> Teams;
+
+	/** Enemies for the current update */
+	TArray<AActor*> Enemies;
+
+	/** Teammates able to look at an enemy, closest first */
+	TArray<TPair<float, AShooterAIController*>> Lookouts;
+
+	/** Time since the last sight update, in seconds */
+	float TimeSinceUpdate = 0.0f;
+
+public:
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+	/** Adds an NPC to a team */
+	void RegisterMember(FName TeamTag, AShooterAIController* Member);
+
+	/** Removes an NPC from its team */
+	void UnregisterMember(FName TeamTag, AShooterAIController* Member);
+
+	/** Returns the enemies a team knows about, or nullptr if the team has no members */
+	const TArray<FShooterKnownEnemy>* GetKnownEnemies(FName TeamTag) const;
+
+	/** Returns true if NPCs should leave sight to their team */
+	bool ReplacesNPCSight() const { return bReplaceNPCSight; }
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Looks for every enemy on behalf of a team and shares what was seen */
+	void UpdateTeam(FShooterTeamPerceptionState& Team);
+
+	/** Returns true if the teammate has an unobstructed view of the enemy */
+	bool CanSee(const AShooterAIController* Member, const AActor* Enemy) const;
+};
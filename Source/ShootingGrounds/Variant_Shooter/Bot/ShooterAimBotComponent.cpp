@@ -0,0 +1,221 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterAimBotComponent.h"
+#include "ShooterCharacter.h"
+#include "ShooterGameMode.h"
+#include "ShooterBotPopulation.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/InputSettings.h"
+#include "Engine/World.h"
+
+UShooterAimBotComponent::UShooterAimBotComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+void UShooterAimBotComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// seed the bot's decisions
+	if (RandomSeed != 0)
+	{
+		RandomStream.Initialize(RandomSeed);
+
+	} else {
+
+		RandomStream.GenerateNewSeed();
+	}
+
+	if (AShooterTrainingSession* Session = GetSession())
+	{
+		// follow our session's targets as they spawn
+		Session->OnShooterTargetSpawned.AddUObject(this, &UShooterAimBotComponent::SetTarget);
+
+		// pick up a target that spawned before we started
+		SetTarget(Session->GetCurrentTarget());
+	}
+
+	UpdateInputScales(Cast<APlayerController>(GetOwner()));
+}
+
+void UShooterAimBotComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	if (AShooterTrainingSession* Session = GetSession())
+	{
+		Session->OnShooterTargetSpawned.RemoveAll(this);
+	}
+}
+
+AShooterTrainingSession* UShooterAimBotComponent::GetSession() const
+{
+	const AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	return GameMode ? GameMode->GetSessionFor(Cast<AController>(GetOwner())) : nullptr;
+}
+
+void UShooterAimBotComponent::SetTarget(AActor* NewTarget)
+{
+	Target = NewTarget;
+
+	if (NewTarget)
+	{
+		PickAimPoint();
+
+		// start the flick early enough for the shot to land after the sampled reaction time
+		ReactionDelayRemaining = FMath::Max(0.0f, SampleReactionTime() - EstimateFlickTime());
+	}
+}
+
+void UShooterAimBotComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	AShooterCharacter* Character = PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr;
+
+	if (!Character)
+	{
+		return;
+	}
+
+	// make sure we have something to shoot with
+	if (!Character->GetCurrentWeapon() && WeaponClass)
+	{
+		Character->AddWeaponClass(WeaponClass);
+	}
+
+	// release the trigger from last frame's shot. Semi auto weapons need a new press for every shot
+	if (bTriggerHeld)
+	{
+		Character->DoStopFiring();
+		bTriggerHeld = false;
+	}
+
+	// ensure we have a live target
+	if (!Target.IsValid() || Target->IsHidden())
+	{
+		return;
+	}
+
+	// still reacting?
+	if (ReactionDelayRemaining > 0.0f)
+	{
+		ReactionDelayRemaining -= DeltaTime;
+		return;
+	}
+
+	// find the angular error between the current view and the aim point
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const FRotator AimError = ((AimPoint - ViewLocation).Rotation() - ViewRotation).GetNormalized();
+
+	// is the aim point within the trigger tolerance?
+	if (FMath::Abs(AimError.Yaw) <= Profile.FireTolerance && FMath::Abs(AimError.Pitch) <= Profile.FireTolerance)
+	{
+		Character->DoStartFiring();
+		bTriggerHeld = true;
+
+		// if the shot doesn't kill the target, go for another point on the next shot
+		PickAimPoint();
+		return;
+	}
+
+	// approach the aim point exponentially, limited by the max turn rate
+	const float Alpha = 1.0f - FMath::Exp(-DeltaTime / Profile.AimTimeConstant);
+	const float MaxStep = Profile.MaxTurnRate * DeltaTime;
+
+	const float YawStep = FMath::Clamp(AimError.Yaw * Alpha, -MaxStep, MaxStep);
+	const float PitchStep = FMath::Clamp(AimError.Pitch * Alpha, -MaxStep, MaxStep);
+
+	// aim through the character so the input gets recorded like a human's
+	Character->DoAim(YawStep / YawInputScale, PitchStep / PitchInputScale);
+
+	// simulated players without an input stack don't apply their rotation input on their own
+	if (!PlayerController->PlayerInput)
+	{
+		PlayerController->UpdateRotation(DeltaTime);
+	}
+}
+
+void UShooterAimBotComponent::PickAimPoint()
+{
+	if (!Target.IsValid())
+	{
+		return;
+	}
+
+	FVector Origin, Extent;
+	Target->GetActorBounds(true, Origin, Extent);
+
+	if (RandomStream.FRand() < Profile.Accuracy)
+	{
+		// aim close to the center of the target
+		AimPoint = Origin + RandomStream.VRand() * Extent.GetMin() * 0.25f;
+
+	} else {
+
+		// aim clearly outside the target bounds
+		AimPoint = Origin + RandomStream.VRand() * Extent.Size() * RandomStream.FRandRange(1.5f, 3.0f);
+	}
+}
+
+float UShooterAimBotComponent::SampleReactionTime()
+{
+	return FMath::Max(0.05f, FShooterBotPopulation::SampleGaussian(RandomStream, Profile.ReactionTime, Profile.ReactionTimeDeviation));
+}
+
+float UShooterAimBotComponent::EstimateFlickTime() const
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (!PlayerController)
+	{
+		return 0.0f;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const FRotator AimError = ((AimPoint - ViewLocation).Rotation() - ViewRotation).GetNormalized();
+	const float ErrorAngle = FMath::Max(FMath::Abs(AimError.Yaw), FMath::Abs(AimError.Pitch));
+	const float Tolerance = FMath::Max(Profile.FireTolerance, 0.01f);
+
+	if (ErrorAngle <= Tolerance)
+	{
+		return 0.0f;
+	}
+
+	// the exponential approach closes the error by a factor of e every time constant, but can't beat the turn rate
+	return FMath::Max(Profile.AimTimeConstant * FMath::Loge(ErrorAngle / Tolerance), ErrorAngle / Profile.MaxTurnRate);
+}
+
+void UShooterAimBotComponent::UpdateInputScales(APlayerController* PlayerController)
+{
+	YawInputScale = PitchInputScale = 1.0f;
+
+	// legacy input scales multiply every aim input on the controller
+	if (PlayerController && GetDefault<UInputSettings>()->bEnableLegacyInputScales)
+	{
+PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		YawInputScale = PlayerController->InputYawScale_DEPRECATED;
+		PitchInputScale = PlayerController->InputPitchScale_DEPRECATED;
+PRAGMA_ENABLE_DEPRECATION_WARNINGS
+	}
+
+	// guard against degenerate scales
+	if (FMath::IsNearlyZero(YawInputScale))
+	{
+		YawInputScale = 1.0f;
+	}
+
+	if (FMath::IsNearlyZero(PitchInputScale))
+	{
+		PitchInputScale = 1.0f;
+	}
+}
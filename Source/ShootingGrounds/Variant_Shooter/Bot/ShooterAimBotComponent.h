@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ShooterAimBotComponent.generated.h"
+
+class AShooterWeapon;
+class APlayerController;
+class AShooterTrainingSession;
+
+/**
+ *  Aim model parameters for the scripted aim bot
+ */
+USTRUCT(BlueprintType)
+struct FShooterAimBotProfile
+{
+	GENERATED_BODY()
+
+	/** Mean time between a target spawning and the bot's shot at it, including the flick */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Reaction", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float ReactionTime = 0.5f;
+
+	/** Standard deviation of the reaction time */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Reaction", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float ReactionTimeDeviation = 0.05f;
+
+	/** Chance for each shot to be aimed on target */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Accuracy", meta = (ClampMin = 0, ClampMax = 1))
+	float Accuracy = 0.85f;
+
+	/** Time constant of the exponential approach towards the aim point. Lower values flick faster */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Aim", meta = (ClampMin = 0.001, ClampMax = 5, Units = "s"))
+	float AimTimeConstant = 0.08f;
+
+	/** Maximum turn rate while aiming, in degrees per second */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Aim", meta = (ClampMin = 1, ClampMax = 10000))
+	float MaxTurnRate = 720.0f;
+
+	/** Angular distance to the aim point at which the bot pulls the trigger */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Aim", meta = (ClampMin = 0, ClampMax = 45, Units = "Degrees"))
+	float FireTolerance = 0.5f;
+};
+
+/**
+ *  Scripted aim bot that plays the shooting range in place of a human
+ *  Lives on a player controller and drives its possessed AShooterCharacter through the regular aim and fire inputs,
+ *  so the session produces the same telemetry as a human player
+ */
+UCLASS(ClassGroup=(Shooter), meta=(BlueprintSpawnableComponent))
+class SHOOTINGGROUNDS_API UShooterAimBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Aim model for this bot */
+	UPROPERTY(EditAnywhere, Category="Bot")
+	FShooterAimBotProfile Profile;
+
+	/** Weapon to grant the pawn if it doesn't have one */
+	UPROPERTY(EditAnywhere, Category="Bot")
+	TSubclassOf<AShooterWeapon> WeaponClass;
+
+	/** Seed for the bot's random decisions. Zero picks a random seed */
+	UPROPERTY(EditAnywhere, Category="Bot")
+	int32 RandomSeed = 0;
+
+protected:
+
+	/** Target currently being engaged */
+	TWeakObjectPtr<AActor> Target;
+
+	/** Point the bot is steering towards */
+	FVector AimPoint = FVector::ZeroVector;
+
+	/** Time left before the bot reacts to the current target */
+	float ReactionDelayRemaining = 0.0f;
+
+	/** Converts degrees to the controller's yaw input units */
+	float YawInputScale = 1.0f;
+
+	/** Converts degrees to the controller's pitch input units */
+	float PitchInputScale = 1.0f;
+
+	/** If true, the trigger was pressed last frame and needs to be released */
+	bool bTriggerHeld = false;
+
+	/** Random stream for all of the bot's decisions */
+	FRandomStream RandomStream;
+
+public:
+
+	/** Constructor */
+	UShooterAimBotComponent();
+
+	/** Starts engaging a new target */
+	void SetTarget(AActor* NewTarget);
+
+protected:
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Steers the aim and fires at the target */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Picks the next point to shoot at, either on or off the target depending on accuracy */
+	void PickAimPoint();
+
+	/** Samples a reaction time from the profile */
+	float SampleReactionTime();
+
+	/** Estimates how long the flick to the current aim point will take */
+	float EstimateFlickTime() const;
+
+	/** Returns the training session of the player we're driving */
+	AShooterTrainingSession* GetSession() const;
+
+	/** Reads the controller's input scaling so aim steps can be given in degrees */
+	void UpdateInputScales(APlayerController* PlayerController);
+};
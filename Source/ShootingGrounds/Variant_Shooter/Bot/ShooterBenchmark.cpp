@@ -0,0 +1,187 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterBenchmark.h"
+#include "ShooterPerfCounters.h"
+#include "ShooterProjectileSubsystem.h"
+#include "ShooterNPCSignificance.h"
+#include "ShootingGrounds.h"
+#include "Misc/FileHelper.h"
+
+FShooterBenchmark::FShooterBenchmark(const FShooterPerfBudgets& InBudgets)
+	: Budgets(InBudgets)
+{
+	// start from clean counters
+	FShooterPerfCounters::Reset();
+	FShooterPerfCounters::SetEnabled(true);
+
+	GUObjectArray.AddUObjectCreateListener(this);
+	bListening = true;
+}
+
+FShooterBenchmark::~FShooterBenchmark()
+{
+	StopListening();
+	FShooterPerfCounters::SetEnabled(false);
+}
+
+void FShooterBenchmark::StopListening()
+{
+	if (bListening)
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+		bListening = false;
+	}
+}
+
+void FShooterBenchmark::Tick(const UWorld& World, double GameThreadTime)
+{
+	// fit game thread time = base + slope * projectiles
+	const UShooterProjectileSubsystem* Projectiles = World.GetSubsystem<UShooterProjectileSubsystem>();
+	const double InFlight = Projectiles ? Projectiles->GetNumInFlight() : 0.0;
+
+	SumX += InFlight;
+	SumY += GameThreadTime;
+	SumXY += InFlight * GameThreadTime;
+	SumXX += InFlight * InFlight;
+	++NumSamples;
+
+	MaxProjectilesInFlight = FMath::Max(MaxProjectilesInFlight, static_cast<int32>(InFlight));
+
+	// fit game thread time = base + slope * NPCs, counting the living NPCs of this world only
+	const UShooterNPCSignificance* Significance = World.GetSubsystem<UShooterNPCSignificance>();
+	const double NumNPCs = Significance ? Significance->GetNumNPCs() : 0.0;
+
+	NPCSumX += NumNPCs;
+	NPCSumY += GameThreadTime;
+	NPCSumXY += NumNPCs * GameThreadTime;
+	NPCSumXX += NumNPCs * NumNPCs;
+
+	MaxNPCs = FMath::Max(MaxNPCs, static_cast<int32>(NumNPCs));
+}
+
+void FShooterBenchmark::OnRoundEnded(int32 Round)
+{
+	const int64 Created = RoundObjectsCreated.exchange(0, std::memory_order_relaxed);
+	MaxObjectsCreatedPerRound = FMath::Max(MaxObjectsCreatedPerRound, Created);
+	++NumRounds;
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("Benchmark: round %d created %lld objects"), Round, Created);
+}
+
+void FShooterBenchmark::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	RoundObjectsCreated.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FShooterBenchmark::OnUObjectArrayShutdown()
+{
+	bListening = false;
+}
+
+void FShooterBenchmark::GatherResults(TArray<FResult>& OutResults) const
+{
+	// average cost of the instrumented scopes
+	auto AddScope = [&OutResults](EShooterPerfScope Scope, const TCHAR* Name, double Budget)
+	{
+		const FShooterPerfCounters::FCounter Counter = FShooterPerfCounters::Get(Scope);
+		OutResults.Add({ Name, TEXT("us"), Counter.GetMicrosecondsPerCall(), Budget, Counter.Calls });
+	};
+
+	AddScope(EShooterPerfScope::WeaponFire, TEXT("WeaponFirePerShot"), Budgets.WeaponFireMicroseconds);
+	AddScope(EShooterPerfScope::TargetReady, TEXT("SpawnToReady"), Budgets.SpawnToReadyMicroseconds);
+	AddScope(EShooterPerfScope::SpawnTarget, TEXT("SpawnTarget"), 0.0);
+	AddScope(EShooterPerfScope::LineOfSight, TEXT("LineOfSightPerEvaluation"), Budgets.LineOfSightMicroseconds);
+	AddScope(EShooterPerfScope::GunTrace, TEXT("GunTrace"), 0.0);
+	AddScope(EShooterPerfScope::SenseEnemies, TEXT("SenseEnemies"), 0.0);
+	AddScope(EShooterPerfScope::NPCAim, TEXT("NPCAim"), 0.0);
+	AddScope(EShooterPerfScope::ExplosionCheck, TEXT("ExplosionCheck"), 0.0);
+	AddScope(EShooterPerfScope::NPCSignificance, TEXT("NPCSignificance"), 0.0);
+	AddScope(EShooterPerfScope::NPCCrowd, TEXT("NPCCrowd"), 0.0);
+	AddScope(EShooterPerfScope::TeamPerception, TEXT("TeamPerception"), 0.0);
+	AddScope(EShooterPerfScope::RagdollBudget, TEXT("RagdollBudget"), 0.0);
+	AddScope(EShooterPerfScope::NPCEvents, TEXT("NPCEvents"), 0.0);
+	AddScope(EShooterPerfScope::NPCStateTree, TEXT("NPCStateTreeTick"), 0.0);
+
+	// slope of the projectile fit. Needs frames with different projectile counts
+	const double Denominator = NumSamples * SumXX - SumX * SumX;
+	FResult& Projectiles = OutResults.Add_GetRef({ TEXT("ProjectilesPer1000InFlight"), TEXT("us"), 0.0, Budgets.ProjectilesPer1000Microseconds, 0 });
+
+	if (MaxProjectilesInFlight > 0 && Denominator > 0.0)
+	{
+		const double Slope = (NumSamples * SumXY - SumX * SumY) / Denominator;
+		Projectiles.Value = FMath::Max(0.0, Slope) * 1000.0 * 1000000.0;
+		Projectiles.Samples = NumSamples;
+	}
+
+	// slope of the NPC fit. Same samples, so it also needs frames with different NPC counts
+	const double NPCDenominator = NumSamples * NPCSumXX - NPCSumX * NPCSumX;
+	FResult& NPCs = OutResults.Add_GetRef({ TEXT("GameThreadPerNPC"), TEXT("us"), 0.0, 0.0, 0 });
+
+	if (MaxNPCs > 0 && NPCDenominator > 0.0)
+	{
+		const double Slope = (NumSamples * NPCSumXY - NPCSumX * NPCSumY) / NPCDenominator;
+		NPCs.Value = FMath::Max(0.0, Slope) * 1000000.0;
+		NPCs.Samples = NumSamples;
+	}
+
+	OutResults.Add({ TEXT("MaxNPCs"), TEXT("npcs"), static_cast<double>(MaxNPCs), 0.0, MaxNPCs > 0 ? NumSamples : 0 });
+
+	OutResults.Add({ TEXT("ObjectsCreatedPerRound"), TEXT("objects"), static_cast<double>(MaxObjectsCreatedPerRound), static_cast<double>(Budgets.ObjectsCreatedPerRound), static_cast<uint64>(NumRounds) });
+}
+
+const TCHAR* FShooterBenchmark::GetStatusName(EStatus Status)
+{
+	switch (Status)
+	{
+	case EStatus::Passed:	return TEXT("Passed");
+	case EStatus::Failed:	return TEXT("Failed");
+	case EStatus::Skipped:	return TEXT("Skipped");
+	default:				return TEXT("Unknown");
+	}
+}
+
+bool FShooterBenchmark::Finish(const FString& BasePath)
+{
+	StopListening();
+
+	TArray<FResult> Results;
+	GatherResults(Results);
+
+	bool bPassed = true;
+
+	TStringBuilder<2048> Json;
+	TStringBuilder<1024> Csv;
+
+	Json.Append(TEXT("{\n\t\"Results\": [\n"));
+	Csv.Append(TEXT("Name,Value,Budget,Unit,Samples,Status\n"));
+
+	for (int32 i = 0; i < Results.Num(); ++i)
+	{
+		const FResult& Result = Results[i];
+		const EStatus Status = Result.GetStatus();
+		bPassed &= Status != EStatus::Failed;
+
+		Json.Appendf(TEXT("\t\t{ \"Name\": \"%s\", \"Value\": %.3f, \"Budget\": %.3f, \"Unit\": \"%s\", \"Samples\": %llu, \"Status\": \"%s\" }%s\n"),
+			Result.Name, Result.Value, Result.Budget, Result.Unit, Result.Samples, GetStatusName(Status), i < Results.Num() - 1 ? TEXT(",") : TEXT(""));
+
+		Csv.Appendf(TEXT("%s,%.3f,%.3f,%s,%llu,%s\n"), Result.Name, Result.Value, Result.Budget, Result.Unit, Result.Samples, GetStatusName(Status));
+
+		if (Result.Samples == 0)
+		{
+			// a budgeted metric that was never measured can't vouch for its path
+			UE_LOG(LogShootingGrounds, Display, TEXT("Benchmark: %s not measured %s"), Result.Name, Status == EStatus::Failed ? TEXT("FAILED") : TEXT("(skipped)"));
+		}
+		else
+		{
+			UE_LOG(LogShootingGrounds, Display, TEXT("Benchmark: %s = %.3f %s (budget %.3f) %s"), Result.Name, Result.Value, Result.Unit, Result.Budget, Status == EStatus::Failed ? TEXT("OVER BUDGET") : TEXT(""));
+		}
+	}
+
+	Json.Appendf(TEXT("\t],\n\t\"Passed\": %s\n}\n"), bPassed ? TEXT("true") : TEXT("false"));
+
+	FFileHelper::SaveStringToFile(Json.ToView(), *(BasePath + TEXT(".json")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	FFileHelper::SaveStringToFile(Csv.ToView(), *(BasePath + TEXT(".csv")), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+
+	return bPassed;
+}
@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UObjectArray.h"
+#include <atomic>
+#include "ShooterBenchmark.generated.h"
+
+/**
+ *  Performance budgets checked by the benchmark mode of the session runner
+ *  A budget of zero reports the metric without checking it. A budgeted metric that was never measured fails
+ */
+USTRUCT()
+struct FShooterPerfBudgets
+{
+	GENERATED_BODY()
+
+	/** Max average cost of a weapon shot, in microseconds */
+	UPROPERTY(Config, EditAnywhere, Category="Budgets")
+	float WeaponFireMicroseconds = 150.0f;
+
+	/** Max average time from a spawn request to the first frame the target can be shot, in microseconds */
+	UPROPERTY(Config, EditAnywhere, Category="Budgets")
+	float SpawnToReadyMicroseconds = 250.0f;
+
+	/** Max average cost of a single NPC line of sight evaluation, in microseconds */
+	UPROPERTY(Config, EditAnywhere, Category="Budgets")
+	float LineOfSightMicroseconds = 40.0f;
+
+	/** Max game thread cost per frame of 1000 projectiles in flight, in microseconds */
+	UPROPERTY(Config, EditAnywhere, Category="Budgets")
+	float ProjectilesPer1000Microseconds = 2000.0f;
+
+	/** Max number of UObjects created during a single round */
+	UPROPERTY(Config, EditAnywhere, Category="Budgets")
+	int32 ObjectsCreatedPerRound = 2000;
+};
+
+/**
+ *  Measures the gameplay hot paths during a bot session and checks them against budgets
+ *  Scope costs come from FShooterPerfCounters, the projectile cost is fitted from the game thread time against
+ *  the number of projectiles in flight in the benchmarked world, the NPC cost is fitted the same way against the
+ *  number of living NPCs in the benchmarked world, and object creation is counted through a UObject create listener
+ *  Results are written as JSON and CSV next to the session telemetry
+ */
+class SHOOTINGGROUNDS_API FShooterBenchmark : public FUObjectArray::FUObjectCreateListener
+{
+public:
+
+	/** Constructor. Starts counting */
+	explicit FShooterBenchmark(const FShooterPerfBudgets& InBudgets);
+
+	/** Destructor. Stops counting */
+	virtual ~FShooterBenchmark();
+
+	/** Samples a frame of the benchmarked world. Game thread time is in seconds */
+	void Tick(const UWorld& World, double GameThreadTime);
+
+	/** Closes the object count for a round */
+	void OnRoundEnded(int32 Round);
+
+	/** Writes the results to <BasePath>.json and <BasePath>.csv. Returns true if no result failed */
+	bool Finish(const FString& BasePath);
+
+	//~Begin FUObjectCreateListener interface
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+	//~End FUObjectCreateListener interface
+
+protected:
+
+	/** Outcome of a single benchmark result */
+	enum class EStatus : uint8
+	{
+		/** Measured and within budget, or measured with no budget */
+		Passed,
+
+		/** Over budget, or budgeted but never measured */
+		Failed,
+
+		/** Not measured and has no budget */
+		Skipped
+	};
+
+	/** A single benchmark result */
+	struct FResult
+	{
+		const TCHAR* Name;
+		const TCHAR* Unit;
+		double Value = 0.0;
+		double Budget = 0.0;
+		uint64 Samples = 0;
+
+		/** Returns the outcome of the result. A metric with a budget has to be measured to pass */
+		EStatus GetStatus() const
+		{
+			if (Samples == 0)
+			{
+				return Budget > 0.0 ? EStatus::Failed : EStatus::Skipped;
+			}
+
+			return Budget <= 0.0 || Value <= Budget ? EStatus::Passed : EStatus::Failed;
+		}
+	};
+
+	/** Returns the display name of a result status */
+	static const TCHAR* GetStatusName(EStatus Status);
+
+	/** Collects all results */
+	void GatherResults(TArray<FResult>& OutResults) const;
+
+	/** Stops listening for object creation */
+	void StopListening();
+
+protected:
+
+	/** Budgets to check */
+	FShooterPerfBudgets Budgets;
+
+	/** Objects created since the current round started. Objects can be created off the game thread */
+	std::atomic<int64> RoundObjectsCreated{0};
+
+	/** Most objects created in a single round */
+	int64 MaxObjectsCreatedPerRound = 0;
+
+	/** Number of rounds played */
+	int32 NumRounds = 0;
+
+	/** Sums for the least squares fit of game thread time against projectiles in flight */
+	double SumX = 0.0;
+	double SumY = 0.0;
+	double SumXY = 0.0;
+	double SumXX = 0.0;
+	uint64 NumSamples = 0;
+
+	/** Most projectiles seen in flight on a single frame */
+	int32 MaxProjectilesInFlight = 0;
+
+	/** Sums for the least squares fit of game thread time against living NPCs, over the same frames */
+	double NPCSumX = 0.0;
+	double NPCSumY = 0.0;
+	double NPCSumXY = 0.0;
+	double NPCSumXX = 0.0;
+
+	/** Most NPCs seen in play on a single frame */
+	int32 MaxNPCs = 0;
+
+	/** If true, we're registered as a create listener */
+	bool bListening = false;
+};
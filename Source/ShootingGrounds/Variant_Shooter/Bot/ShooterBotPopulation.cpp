@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterBotPopulation.h"
+#include "ShootingGrounds.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+bool FShooterBotPopulation::LoadCentroids(const FString& Path)
+{
+	Archetypes.Reset();
+
+	const FString FullPath = FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectDir(), Path) : Path;
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FullPath) || Lines.Num() < 2)
+	{
+		UE_LOG(LogShootingGrounds, Error, TEXT("Could not read cluster centroids from %s"), *FullPath);
+		return false;
+	}
+
+	// find the columns we need by name, since the subset files only have some of them
+	TArray<FString> Header;
+	Lines[0].ParseIntoArray(Header, TEXT(","));
+
+	const int32 ClusterColumn = Header.IndexOfByKey(TEXT("cluster"));
+	const int32 AccuracyColumn = Header.IndexOfByKey(TEXT("Accuracy"));
+	const int32 StdDevAccColumn = Header.IndexOfByKey(TEXT("StdDevAcc"));
+	const int32 ReactionTimeColumn = Header.IndexOfByKey(TEXT("AvgReactionTime"));
+	const int32 StdDevReactionTimeColumn = Header.IndexOfByKey(TEXT("StdDevReactionTime"));
+
+	if (AccuracyColumn == INDEX_NONE || ReactionTimeColumn == INDEX_NONE)
+	{
+		UE_LOG(LogShootingGrounds, Error, TEXT("%s needs at least the Accuracy and AvgReactionTime columns"), *FullPath);
+		return false;
+	}
+
+	TArray<FString> Fields;
+
+	for (int32 i = 1; i < Lines.Num(); ++i)
+	{
+		Lines[i].ParseIntoArray(Fields, TEXT(","));
+
+		if (Fields.Num() != Header.Num())
+		{
+			continue;
+		}
+
+		// the pipeline stores accuracies in percent
+		FShooterBotArchetype& Archetype = Archetypes.AddDefaulted_GetRef();
+		Archetype.Cluster = ClusterColumn != INDEX_NONE ? FCString::Atoi(*Fields[ClusterColumn]) : i - 1;
+		Archetype.Accuracy = FMath::Clamp(FCString::Atof(*Fields[AccuracyColumn]) / 100.0f, 0.0f, 1.0f);
+		Archetype.ReactionTime = FMath::Max(0.0f, FCString::Atof(*Fields[ReactionTimeColumn]));
+
+		if (StdDevAccColumn != INDEX_NONE)
+		{
+			Archetype.AccuracyDeviation = FMath::Max(0.0f, FCString::Atof(*Fields[StdDevAccColumn]) / 100.0f);
+		}
+
+		if (StdDevReactionTimeColumn != INDEX_NONE)
+		{
+			Archetype.ReactionTimeDeviation = FMath::Max(0.0f, FCString::Atof(*Fields[StdDevReactionTimeColumn]));
+		}
+	}
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("Loaded %d player archetypes from %s"), Archetypes.Num(), *FullPath);
+	return !Archetypes.IsEmpty();
+}
+
+const FShooterBotArchetype& FShooterBotPopulation::SampleArchetype(FRandomStream& Stream) const
+{
+	check(!Archetypes.IsEmpty());
+	return Archetypes[Stream.RandHelper(Archetypes.Num())];
+}
+
+float FShooterBotPopulation::SampleRoundAccuracy(const FShooterBotArchetype& Archetype, FRandomStream& Stream)
+{
+	return FMath::Clamp(SampleGaussian(Stream, Archetype.Accuracy, Archetype.AccuracyDeviation), 0.0f, 1.0f);
+}
+
+float FShooterBotPopulation::SampleGaussian(FRandomStream& Stream, float Mean, float Deviation)
+{
+	// Box-Muller transform
+	const float U1 = FMath::Max(Stream.FRand(), KINDA_SMALL_NUMBER);
+	const float U2 = Stream.FRand();
+
+	return Mean + Deviation * FMath::Sqrt(-2.0f * FMath::Loge(U1)) * FMath::Cos(2.0f * PI * U2);
+}
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Player archetype taken from a cluster centroid of the player modeling pipeline
+ *  Accuracy values are fractions in [0, 1], times are in seconds
+ */
+struct FShooterBotArchetype
+{
+	/** Cluster this archetype was taken from */
+	int32 Cluster = 0;
+
+	/** Mean accuracy over a session */
+	float Accuracy = 0.85f;
+
+	/** Round to round standard deviation of accuracy */
+	float AccuracyDeviation = 0.05f;
+
+	/** Mean time from a target spawn to the shot that hits it */
+	float ReactionTime = 1.0f;
+
+	/** Shot to shot standard deviation of the reaction time */
+	float ReactionTimeDeviation = 0.1f;
+};
+
+/**
+ *  Population of simulated players built from the cluster centroids written by player_modeling.py
+ *  (outputs/full_clusters_k*_centroids.csv). Each simulated player is assigned one cluster,
+ *  which doubles as the ground truth label when checking the clustering pipeline
+ */
+class SHOOTINGGROUNDS_API FShooterBotPopulation
+{
+public:
+
+	/** Loads the archetypes from a centroids CSV. Relative paths are resolved against the project directory */
+	bool LoadCentroids(const FString& Path);
+
+	/** Returns true if any archetypes were loaded */
+	bool IsEmpty() const { return Archetypes.IsEmpty(); }
+
+	/** Returns the loaded archetypes */
+	const TArray<FShooterBotArchetype>& GetArchetypes() const { return Archetypes; }
+
+	/** Picks an archetype for a new simulated player, with every cluster equally likely */
+	const FShooterBotArchetype& SampleArchetype(FRandomStream& Stream) const;
+
+	/** Draws the accuracy for one round of a player of the given archetype */
+	static float SampleRoundAccuracy(const FShooterBotArchetype& Archetype, FRandomStream& Stream);
+
+	/** Draws a normally distributed value */
+	static float SampleGaussian(FRandomStream& Stream, float Mean, float Deviation);
+
+protected:
+
+	/** Archetypes, one per cluster */
+	TArray<FShooterBotArchetype> Archetypes;
+};
@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterReplayComponent.h"
+#include "ShooterCharacter.h"
+#include "ShooterTrainingSession.h"
+#include "ShooterWeapon.h"
+#include "Camera/CameraComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+UShooterReplayComponent::UShooterReplayComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+void UShooterReplayComponent::SetReplay(const FShooterReplayReader& Reader, AShooterTrainingSession* InSession)
+{
+	Session = InSession;
+	Events = Reader.GetEvents();
+	NextEvent = 0;
+}
+
+bool UShooterReplayComponent::GetRecordedScore(int32& OutHits, int32& OutMisses) const
+{
+	if (Events.Num() == 0 || Events.Last().Type != EShooterReplayEvent::End)
+	{
+		return false;
+	}
+
+	OutHits = Events.Last().Hits;
+	OutMisses = Events.Last().Misses;
+	return true;
+}
+
+void UShooterReplayComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	AShooterCharacter* Character = PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr;
+
+	if (!Character || !Session.IsValid() || IsFinished())
+	{
+		return;
+	}
+
+	// the recording is the only input, so a local player can't throw the playback off
+	if (Character->InputEnabled())
+	{
+		Character->DisableInput(PlayerController);
+	}
+
+	// play everything that's due on the session's clock. Frames don't need to line up with the recording's
+	const double Time = Session->GetReplayTime();
+	bool bAddedRotationInput = false;
+
+	while (NextEvent < Events.Num() && Events[NextEvent].Time <= Time)
+	{
+		bAddedRotationInput |= PlayEvent(Events[NextEvent++], PlayerController, Character);
+	}
+
+	// simulated players without an input stack don't apply their rotation input on their own
+	if (bAddedRotationInput && !PlayerController->PlayerInput)
+	{
+		PlayerController->UpdateRotation(DeltaTime);
+	}
+}
+
+bool UShooterReplayComponent::PlayEvent(const FShooterReplayEvent& Event, APlayerController* PlayerController, AShooterCharacter* Character)
+{
+	switch (Event.Type)
+	{
+	case EShooterReplayEvent::Aim:
+
+		// goes through the character so the replayed session records it like the original
+		Character->DoAim(Event.Yaw, Event.Pitch);
+		return true;
+
+	case EShooterReplayEvent::FirePressed:
+		Character->DoStartFiring();
+		break;
+
+	case EShooterReplayEvent::FireReleased:
+		Character->DoStopFiring();
+		break;
+
+	case EShooterReplayEvent::Keyframe:
+
+		// snap the pawn and view back to the recording
+		Character->SetActorLocation(Event.Location, false, nullptr, ETeleportType::TeleportPhysics);
+		PlayerController->SetControlRotation(Event.Rotation);
+		Character->FaceRotation(Event.Rotation);
+
+		// shots trace from the camera, which otherwise only catches up with the control rotation on the next view update
+		Character->GetFirstPersonCameraComponent()->SetWorldRotation(Event.Rotation);
+		break;
+
+	case EShooterReplayEvent::RoundStarted:
+		Session->StartRound();
+		break;
+
+	case EShooterReplayEvent::Weapon:
+
+		if (!Event.WeaponClassPath.IsEmpty())
+		{
+			if (UClass* WeaponClass = LoadClass<AShooterWeapon>(nullptr, *Event.WeaponClassPath))
+			{
+				Character->EquipWeaponClass(WeaponClass);
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return false;
+}
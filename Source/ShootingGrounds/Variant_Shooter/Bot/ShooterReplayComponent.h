@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ShooterReplay.h"
+#include "ShooterReplayComponent.generated.h"
+
+class AShooterCharacter;
+class AShooterTrainingSession;
+
+/**
+ *  Plays a recorded session replay back through a player controller
+ *  Lives on the player controller and feeds the recorded aim and fire input to its possessed AShooterCharacter
+ *  on the session's clock, snapping the pawn to the recorded keyframes so small integration differences don't add up
+ */
+UCLASS(ClassGroup=(Shooter))
+class SHOOTINGGROUNDS_API UShooterReplayComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Session the replay is played into */
+	TWeakObjectPtr<AShooterTrainingSession> Session;
+
+	/** Recorded events, in time order */
+	TArray<FShooterReplayEvent> Events;
+
+	/** Index of the next event to play */
+	int32 NextEvent = 0;
+
+public:
+
+	/** Constructor */
+	UShooterReplayComponent();
+
+	/** Sets the replay to play into a session. The session's seed and round config should already match the recording */
+	void SetReplay(const FShooterReplayReader& Reader, AShooterTrainingSession* InSession);
+
+	/** Returns true once every recorded event was played */
+	bool IsFinished() const { return NextEvent >= Events.Num(); }
+
+	/** Returns the final score of the recording. Returns false if the recording ended before the session finished */
+	bool GetRecordedScore(int32& OutHits, int32& OutMisses) const;
+
+	/** Returns the length of the recording in seconds */
+	double GetDuration() const { return Events.Num() > 0 ? Events.Last().Time : 0.0; }
+
+protected:
+
+	/** Plays the events that are due */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Applies a single recorded event to the character. Returns true if it added rotation input */
+	bool PlayEvent(const FShooterReplayEvent& Event, APlayerController* PlayerController, AShooterCharacter* Character);
+};
@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterReplayPlayer.h"
+#include "ShooterReplayComponent.h"
+#include "ShooterSessionRunner.h"
+#include "ShooterGameMode.h"
+#include "ShooterTrainingSession.h"
+#include "ShooterRoundConfig.h"
+#include "ShooterReplay.h"
+#include "ShootingGrounds.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+bool UShooterReplayPlayer::IsRequested()
+{
+	FString Filename;
+	return FParse::Value(FCommandLine::Get(), TEXT("ShooterReplay="), Filename);
+}
+
+bool UShooterReplayPlayer::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// the aim bot would fight the recorded input
+	return IsRequested() && !UShooterSessionRunner::IsRequested() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UShooterReplayPlayer::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterReplayPlayer::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	AShooterGameMode* GameMode = InWorld.GetAuthGameMode<AShooterGameMode>();
+	if (!GameMode)
+	{
+		UE_LOG(LogShootingGrounds, Warning, TEXT("ShooterReplay: %s doesn't use a shooter game mode, nothing to play"), *InWorld.GetMapName());
+		return;
+	}
+
+	// relative paths are taken from the project directory
+	FParse::Value(FCommandLine::Get(), TEXT("ShooterReplay="), ReplayFilename);
+
+	if (FPaths::IsRelative(ReplayFilename))
+	{
+		ReplayFilename = FPaths::Combine(FPaths::ProjectDir(), ReplayFilename);
+	}
+
+	FShooterReplayReader Reader;
+	if (!Reader.Load(ReplayFilename))
+	{
+		return;
+	}
+
+	// play the recorded rounds. Rounds start when the recording says so
+	ReplayConfig = CreateReplayConfig(GameMode, Reader.GetHeader());
+	GameMode->SetRoundConfig(ReplayConfig);
+	GameMode->SetAutoStartRounds(false);
+
+	// drive the local player, or a simulated one if there is none, like on a dedicated server
+	APlayerController* PlayerController = InWorld.GetFirstPlayerController();
+
+	if (!PlayerController)
+	{
+		PlayerController = GameMode->SpawnSimulatedPlayer();
+	}
+
+	AShooterTrainingSession* Session = GameMode->GetSessionFor(PlayerController);
+	if (!Session)
+	{
+		UE_LOG(LogShootingGrounds, Warning, TEXT("ShooterReplay: no session to play into"));
+		return;
+	}
+
+	// NPCs shooting around the player must not change the score, which the replay check proves
+	int32 NumNPCs = 0;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("ShooterNPCs="), NumNPCs) && NumNPCs > 0)
+	{
+		UShooterSessionRunner::SpawnNPCs(GameMode, PlayerController, NumNPCs);
+	}
+
+	// the recorded seed rebuilds the spawn schedules, so the targets come up where they did
+	Session->SetSessionSeed(Reader.GetHeader().SessionSeed);
+	Session->OnShooterSessionFinished.AddUObject(this, &UShooterReplayPlayer::OnSessionFinished, Session);
+
+	ReplayComponent = NewObject<UShooterReplayComponent>(PlayerController, TEXT("ShooterReplay"));
+	ReplayComponent->SetReplay(Reader, Session);
+	ReplayComponent->RegisterComponent();
+
+	WallStartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("ShooterReplay: playing %s, %d events over %.1f seconds"), *ReplayFilename, Reader.GetEvents().Num(), ReplayComponent->GetDuration());
+}
+
+UShooterRoundConfig* UShooterReplayPlayer::CreateReplayConfig(const AShooterGameMode* GameMode, const FShooterReplayHeader& Header)
+{
+	// start from the level's config, so anything the replay doesn't store stays the same
+	UShooterRoundConfig* Config = DuplicateObject<UShooterRoundConfig>(GameMode->GetRoundConfig(), this);
+
+	const FShooterRoundDefinition LastRound = Config->Rounds.Num() > 0 ? Config->Rounds.Last() : FShooterRoundDefinition();
+	const int32 NumDefinedRounds = Config->Rounds.Num();
+	Config->Rounds.SetNum(Header.Rounds.Num());
+
+	for (int32 i = 0; i < Header.Rounds.Num(); ++i)
+	{
+		if (i >= NumDefinedRounds)
+		{
+			Config->Rounds[i] = LastRound;
+		}
+
+		Config->Rounds[i].Duration = Header.Rounds[i].Duration;
+		Config->Rounds[i].SpawnSeed = Header.Rounds[i].SpawnSeed;
+	}
+
+	Config->IntermissionDuration = Header.IntermissionDuration;
+
+	return Config;
+}
+
+void UShooterReplayPlayer::OnSessionFinished(AShooterTrainingSession* Session)
+{
+	const double WallSeconds = FPlatformTime::Seconds() - WallStartTime;
+	const double ReplaySeconds = ReplayComponent ? ReplayComponent->GetDuration() : 0.0;
+
+	// the recording ends with the original score, which the playback should reproduce
+	int32 RecordedHits = 0;
+	int32 RecordedMisses = 0;
+	bool bMatched = true;
+
+	if (ReplayComponent && ReplayComponent->GetRecordedScore(RecordedHits, RecordedMisses))
+	{
+		bMatched = RecordedHits == Session->SuccessfulHits && RecordedMisses == Session->MissedShots;
+
+		UE_LOG(LogShootingGrounds, Display, TEXT("ShooterReplay: %s. Recorded %d hits %d misses, replayed %d hits %d misses"),
+			bMatched ? TEXT("playback matches the recording") : TEXT("playback DIVERGED from the recording"), RecordedHits, RecordedMisses, Session->SuccessfulHits, Session->MissedShots);
+
+	} else {
+
+		UE_LOG(LogShootingGrounds, Display, TEXT("ShooterReplay: the recording ended before its session finished, nothing to check against"));
+	}
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("ShooterReplay: played %.1f seconds in %.1f seconds, %.1fx realtime"), ReplaySeconds, WallSeconds, WallSeconds > 0.0 ? ReplaySeconds / WallSeconds : 0.0);
+
+	if (FApp::IsUnattended())
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bMatched ? 0 : 1, TEXT("ShooterReplayPlayer"));
+	}
+}
@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterReplayPlayer.generated.h"
+
+class AShooterGameMode;
+class AShooterTrainingSession;
+class UShooterReplayComponent;
+class UShooterRoundConfig;
+struct FShooterReplayHeader;
+
+/**
+ *  Plays back a session replay recorded by a training session
+ *  Only created when -ShooterReplay is on the command line, for example:
+ *
+ *  UnrealEditor-Cmd ShootingGrounds.uproject <Map> -game -nullrhi -unattended -benchmark -fps=60 -ShooterReplay=Saved/Telemetry/Session_<date>.replay
+ *
+ *  The session is rebuilt from the recorded seed and round settings, so the targets spawn where they did, and the
+ *  recorded input is fed to the player's character. The replayed session writes the usual telemetry log, so batch
+ *  re-analysis can run on replays the same way it runs on live sessions. -benchmark -fps=60 steps the world with a
+ *  fixed time step as fast as the machine allows. With -unattended the process exits when the replay is done, with a
+ *  non zero code if the final score differs from the recording. Without it the world stays up for viewing
+ *
+ *  -ShooterNPCs=N spawns NPCs like the session runner does. Only the player's own shots are scored, so a session
+ *  recorded by the bot with NPCs around replays to the same score with them around too:
+ *
+ *  UnrealEditor-Cmd ShootingGrounds.uproject <Map> -game -nullrhi -unattended -ShooterBot -ShooterNPCs=50
+ *  UnrealEditor-Cmd ShootingGrounds.uproject <Map> -game -nullrhi -unattended -ShooterNPCs=50 -ShooterReplay=Saved/Telemetry/Session_<date>.replay
+ */
+UCLASS()
+class SHOOTINGGROUNDS_API UShooterReplayPlayer : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Component feeding the recorded input to the player */
+	UPROPERTY(Transient)
+	TObjectPtr<UShooterReplayComponent> ReplayComponent;
+
+	/** Round config rebuilt from the recording */
+	UPROPERTY(Transient)
+	TObjectPtr<UShooterRoundConfig> ReplayConfig;
+
+	/** Replay being played */
+	FString ReplayFilename;
+
+	/** Wall clock time when playback started */
+	double WallStartTime = 0.0;
+
+public:
+
+	/** Returns true if a replay was requested on the command line */
+	static bool IsRequested();
+
+	//~Begin UWorldSubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem interface
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Builds a round config that plays the recorded rounds */
+	UShooterRoundConfig* CreateReplayConfig(const AShooterGameMode* GameMode, const FShooterReplayHeader& Header);
+
+	/** Checks the replayed score against the recording and exits if running unattended */
+	void OnSessionFinished(AShooterTrainingSession* Session);
+};
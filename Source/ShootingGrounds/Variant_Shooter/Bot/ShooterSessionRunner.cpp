@@ -0,0 +1,614 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterSessionRunner.h"
+#include "ShooterAimBotComponent.h"
+#include "ShooterGameMode.h"
+#include "ShooterTrainingSession.h"
+#include "ShooterRoundConfig.h"
+#include "ShooterFrameTiming.h"
+#include "ShooterWeapon.h"
+#include "ShooterNPC.h"
+#include "ShooterProjectile.h"
+#include "ShooterProjectileSubsystem.h"
+#include "ShooterCrowdSubsystem.h"
+#include "ShootingGrounds.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+#include "TimerManager.h"
+
+bool UShooterSessionRunner::IsRequested()
+{
+	return FParse::Param(FCommandLine::Get(), TEXT("ShooterBot"));
+}
+
+bool UShooterSessionRunner::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return IsRequested() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UShooterSessionRunner::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterSessionRunner::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	AShooterGameMode* GameMode = InWorld.GetAuthGameMode<AShooterGameMode>();
+	if (!GameMode)
+	{
+		UE_LOG(LogShootingGrounds, Warning, TEXT("ShooterBot: %s doesn't use a shooter game mode, nothing to run"), *InWorld.GetMapName());
+		return;
+	}
+
+	// apply the round overrides before the first round starts
+	RunConfig = CreateRunConfig(GameMode);
+
+	if (RunConfig)
+	{
+		GameMode->SetRoundConfig(RunConfig);
+	}
+
+	// nobody is there to press the start button
+	GameMode->SetAutoStartRounds(true);
+
+	// isolate the sessions before any of them begins play
+	FParse::Value(FCommandLine::Get(), TEXT("ShooterSessions="), NumSessions);
+	NumSessions = FMath::Max(1, NumSessions);
+
+	if (NumSessions > 1)
+	{
+		GameMode->SetHostMultipleSessions(true);
+	}
+
+	// drive the local player, or a simulated one if there is none, like on a dedicated server
+	APlayerController* PlayerController = InWorld.GetFirstPlayerController();
+
+	if (!PlayerController)
+	{
+		PlayerController = GameMode->SpawnSimulatedPlayer();
+	}
+
+	AimBot = AttachAimBot(PlayerController, 0);
+	PrimarySession = GameMode->GetSessionFor(PlayerController);
+
+	// every other session is played by a simulated player
+	for (int32 SessionIndex = 1; SessionIndex < NumSessions; ++SessionIndex)
+	{
+		if (APlayerController* SimulatedPlayer = GameMode->SpawnSimulatedPlayer())
+		{
+			SimulatedAimBots.Add(AttachAimBot(SimulatedPlayer, SessionIndex));
+		}
+	}
+
+	// the run ends once every session has played all its rounds
+	NumSessions = GameMode->GetSessions().Num();
+
+	for (AShooterTrainingSession* Session : GameMode->GetSessions())
+	{
+		Session->OnShooterSessionFinished.AddUObject(this, &UShooterSessionRunner::OnSessionFinished, Session);
+	}
+
+	// measure the hot paths against their budgets
+	if (FParse::Param(FCommandLine::Get(), TEXT("ShooterBenchmark")))
+	{
+		Benchmark = MakeUnique<FShooterBenchmark>(Budgets);
+
+		// launch the projectiles well above the start, out of the way of the drill
+		ProjectileClass = BenchmarkProjectileClass.LoadSynchronous();
+		AActor* PlayerStart = GameMode->FindPlayerStart(PlayerController);
+
+		if (ProjectileClass && PlayerStart)
+		{
+			ProjectileOrigin = PlayerStart->GetActorLocation() + FVector(0.0f, 0.0f, 5000.0f);
+		}
+		else
+		{
+			ProjectileClass = nullptr;
+			UE_LOG(LogShootingGrounds, Warning, TEXT("ShooterBot: no benchmark projectile class or player start, the projectile cost won't be measured"));
+		}
+	}
+
+	// load the level up with NPCs
+	int32 NumNPCs = 0;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("ShooterNPCs="), NumNPCs) && NumNPCs > 0)
+	{
+		for (AShooterNPC* NPC : SpawnNPCs(GameMode, PlayerController, NumNPCs))
+		{
+			BenchmarkNPCs.Add(NPC);
+		}
+	}
+
+	int32 CrowdSize = 0;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("ShooterCrowd="), CrowdSize) && CrowdSize > 0)
+	{
+		UShooterCrowdSubsystem* Crowd = InWorld.GetSubsystem<UShooterCrowdSubsystem>();
+		AActor* PlayerStart = GameMode->FindPlayerStart(PlayerController);
+
+		if (Crowd && PlayerStart)
+		{
+			Crowd->SpawnCrowd(PlayerStart->GetActorLocation(), CrowdRadius, CrowdSize, 1);
+			UE_LOG(LogShootingGrounds, Display, TEXT("ShooterBot: added %d crowd NPCs"), CrowdSize);
+		}
+	}
+
+	// play a population of simulated players
+	if (AimBot && InitPopulation())
+	{
+		BeginPlayer();
+	}
+
+	if (PrimarySession.IsValid())
+	{
+		PrimarySession->OnShooterRoundEnded.AddUObject(this, &UShooterSessionRunner::OnRoundEnded);
+	}
+
+	SimulationStartTime = InWorld.GetTimeSeconds();
+	WallStartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("ShooterBot: running %d rounds in %d sessions on %s"), GameMode->GetRoundConfig()->GetNumRounds(), NumSessions, *InWorld.GetMapName());
+}
+
+UShooterRoundConfig* UShooterSessionRunner::CreateRunConfig(const AShooterGameMode* GameMode)
+{
+	int32 NumRounds = 0;
+	float RoundLength = 0.0f;
+
+	const bool bHasRounds = FParse::Value(FCommandLine::Get(), TEXT("ShooterRounds="), NumRounds) && NumRounds > 0;
+	const bool bHasRoundLength = FParse::Value(FCommandLine::Get(), TEXT("ShooterRoundLength="), RoundLength) && RoundLength > 0.0f;
+
+	if (!bHasRounds && !bHasRoundLength)
+	{
+		return nullptr;
+	}
+
+	// start from the config the level would have used
+	UShooterRoundConfig* Config = DuplicateObject<UShooterRoundConfig>(GameMode->GetRoundConfig(), this);
+
+	if (bHasRounds)
+	{
+		// repeat the last defined round to fill extra rounds
+		const FShooterRoundDefinition LastRound = Config->Rounds.Num() > 0 ? Config->Rounds.Last() : FShooterRoundDefinition();
+		const int32 NumDefinedRounds = Config->Rounds.Num();
+		Config->Rounds.SetNum(NumRounds);
+
+		for (int32 i = NumDefinedRounds; i < NumRounds; ++i)
+		{
+			Config->Rounds[i] = LastRound;
+		}
+	}
+
+	if (bHasRoundLength)
+	{
+		for (FShooterRoundDefinition& Round : Config->Rounds)
+		{
+			Round.Duration = RoundLength;
+		}
+	}
+
+	return Config;
+}
+
+UShooterAimBotComponent* UShooterSessionRunner::AttachAimBot(APlayerController* PlayerController, int32 SessionIndex)
+{
+	if (!PlayerController)
+	{
+		UE_LOG(LogShootingGrounds, Warning, TEXT("ShooterBot: no player to drive"));
+		return nullptr;
+	}
+
+	UShooterAimBotComponent* NewAimBot = NewObject<UShooterAimBotComponent>(PlayerController, TEXT("ShooterAimBot"));
+
+	// apply the profile overrides
+	FParse::Value(FCommandLine::Get(), TEXT("BotReaction="), NewAimBot->Profile.ReactionTime);
+	FParse::Value(FCommandLine::Get(), TEXT("BotReactionDev="), NewAimBot->Profile.ReactionTimeDeviation);
+	FParse::Value(FCommandLine::Get(), TEXT("BotAccuracy="), NewAimBot->Profile.Accuracy);
+	FParse::Value(FCommandLine::Get(), TEXT("BotSeed="), NewAimBot->RandomSeed);
+
+	// keep seeded runs reproducible without every session playing the same shots
+	if (NewAimBot->RandomSeed != 0)
+	{
+		NewAimBot->RandomSeed += SessionIndex;
+	}
+
+	FString WeaponPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("BotWeapon="), WeaponPath))
+	{
+		NewAimBot->WeaponClass = LoadClass<AShooterWeapon>(nullptr, *WeaponPath);
+	}
+
+	NewAimBot->RegisterComponent();
+	return NewAimBot;
+}
+
+void UShooterSessionRunner::Tick(float DeltaTime)
+{
+	// the game thread time is from the previous frame, which is the last complete one
+	const FShooterFrameTiming Timing = FShooterFrameTiming::Capture();
+
+	FrameTimes.Record(Timing.DeltaTime);
+	GameThreadTimes.Record(Timing.GameThreadTime);
+	GameThreadSeconds += Timing.GameThreadTime;
+	++NumFrames;
+
+	if (Benchmark)
+	{
+		Benchmark->Tick(*GetWorld(), Timing.GameThreadTime);
+		UpdateBenchmarkProjectiles();
+		UpdateBenchmarkNPCs();
+	}
+}
+
+void UShooterSessionRunner::UpdateBenchmarkProjectiles()
+{
+	const UShooterProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UShooterProjectileSubsystem>();
+
+	if (!ProjectileClass || !Projectiles)
+	{
+		return;
+	}
+
+	// step through 0, 1/4, 1/2, 3/4 and all of the projectiles, so the fit sees a spread of counts
+	constexpr int32 NumSteps = 5;
+	const double ElapsedTime = GetWorld()->GetTimeSeconds() - SimulationStartTime;
+	const int32 Step = FMath::FloorToInt32(ElapsedTime / FMath::Max(BenchmarkProjectileStepTime, 0.1f)) % NumSteps;
+	const int32 TargetInFlight = BenchmarkProjectiles * Step / (NumSteps - 1);
+
+	// spread the launches over a few frames so they don't show up as a single spike
+	const int32 NumToLaunch = FMath::Min(TargetInFlight - Projectiles->GetNumInFlight(), FMath::Max(1, BenchmarkProjectiles / 20));
+
+	if (NumToLaunch <= 0)
+	{
+		return;
+	}
+
+	// projectiles apply their hits on behalf of their instigator
+	const APlayerController* PlayerController = AimBot ? Cast<APlayerController>(AimBot->GetOwner()) : nullptr;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.Instigator = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	if (!SpawnParams.Instigator)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < NumToLaunch; ++i)
+	{
+		// upwards in a wide cone, so they stay in flight for a while before coming down
+		const FVector Direction = FMath::VRandCone(FVector::UpVector, FMath::DegreesToRadians(60.0f));
+		GetWorld()->SpawnActor<AShooterProjectile>(ProjectileClass, ProjectileOrigin, Direction.Rotation(), SpawnParams);
+	}
+}
+
+void UShooterSessionRunner::UpdateBenchmarkNPCs()
+{
+	if (BenchmarkNPCs.IsEmpty())
+	{
+		return;
+	}
+
+	// same levels as the projectiles, but each held for a whole projectile cycle. Every NPC count then sees every
+	// projectile count equally often, so neither fit picks up the other's cost
+	constexpr int32 NumSteps = 5;
+	const double ElapsedTime = GetWorld()->GetTimeSeconds() - SimulationStartTime;
+	const int32 Step = FMath::FloorToInt32(ElapsedTime / (FMath::Max(BenchmarkProjectileStepTime, 0.1f) * NumSteps)) % NumSteps;
+
+	// NPCs killed in the drill are gone for good
+	BenchmarkNPCs.RemoveAll([](const TWeakObjectPtr<AShooterNPC>& NPC) { return !NPC.IsValid() || NPC->IsDead(); });
+
+	const int32 TargetActive = BenchmarkNPCs.Num() * Step / (NumSteps - 1);
+
+	int32 NumActive = 0;
+
+	for (const TWeakObjectPtr<AShooterNPC>& NPC : BenchmarkNPCs)
+	{
+		NumActive += NPC->IsDormant() ? 0 : 1;
+	}
+
+	// spread the changes over a few frames so they don't show up as a single spike
+	int32 NumToChange = FMath::Min(FMath::Abs(TargetActive - NumActive), FMath::Max(1, BenchmarkNPCs.Num() / 20));
+	const bool bActivate = TargetActive > NumActive;
+
+	for (const TWeakObjectPtr<AShooterNPC>& NPC : BenchmarkNPCs)
+	{
+		if (NumToChange <= 0)
+		{
+			break;
+		}
+
+		if (NPC->IsDormant() != bActivate)
+		{
+			continue;
+		}
+
+		// NPCs come back where they were taken out of play
+		if (bActivate)
+		{
+			NPC->ActivateNPC(NPC->GetActorLocation(), NPC->GetActorRotation());
+		}
+		else
+		{
+			NPC->DeactivateNPC();
+		}
+
+		--NumToChange;
+	}
+}
+
+void UShooterSessionRunner::Deinitialize()
+{
+	Benchmark.Reset();
+
+	Super::Deinitialize();
+}
+
+TArray<AShooterNPC*> UShooterSessionRunner::SpawnNPCs(AShooterGameMode* GameMode, APlayerController* PlayerController, int32 Count)
+{
+	TArray<AShooterNPC*> NPCs;
+
+	// the NPC settings are config, so the class defaults hold them
+	const UShooterSessionRunner* Settings = GetDefault<UShooterSessionRunner>();
+	UClass* Class = Settings->NPCClass.LoadSynchronous();
+	AActor* PlayerStart = GameMode->FindPlayerStart(PlayerController);
+
+	if (!Class || !PlayerStart)
+	{
+		UE_LOG(LogShootingGrounds, Warning, TEXT("ShooterBot: can't spawn NPCs, set an NPC class and make sure the map has a player start"));
+		return NPCs;
+	}
+
+	// fill a square grid centered on the start, leaving the center for the player
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count + 1)));
+	const FVector Origin = PlayerStart->GetActorLocation();
+	const float Spacing = Settings->NPCSpacing;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Cell = 0; Cell < Side * Side && NPCs.Num() < Count; ++Cell)
+	{
+		const int32 X = Cell % Side - Side / 2;
+		const int32 Y = Cell / Side - Side / 2;
+
+		if (X == 0 && Y == 0)
+		{
+			continue;
+		}
+
+		const FVector Location = Origin + FVector(X * Spacing, Y * Spacing, 0.0f);
+		const FRotator Rotation = (Origin - Location).Rotation();
+
+		if (AShooterNPC* NPC = GameMode->GetWorld()->SpawnActor<AShooterNPC>(Class, Location, FRotator(0.0f, Rotation.Yaw, 0.0f), SpawnParams))
+		{
+			// spawned pawns only get their AI controller if the class asks for it
+			if (!NPC->GetController())
+			{
+				NPC->SpawnDefaultController();
+			}
+
+			NPCs.Add(NPC);
+		}
+	}
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("ShooterBot: spawned %d NPCs"), NPCs.Num());
+
+	return NPCs;
+}
+
+bool UShooterSessionRunner::InitPopulation()
+{
+	FString CentroidsPath;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ShooterPopulation="), CentroidsPath) || !Population.LoadCentroids(CentroidsPath))
+	{
+		return false;
+	}
+
+	FParse::Value(FCommandLine::Get(), TEXT("ShooterPlayers="), NumPlayers);
+	NumPlayers = FMath::Max(1, NumPlayers);
+
+	// reuse the bot seed so populations can be regenerated
+	int32 Seed = 0;
+	if (FParse::Value(FCommandLine::Get(), TEXT("BotSeed="), Seed) && Seed != 0)
+	{
+		PopulationStream.Initialize(Seed);
+
+	} else {
+
+		PopulationStream.GenerateNewSeed();
+	}
+
+	// features in the player modeling input format. Labels are kept apart so they don't leak into the clustering
+	const FString BasePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"), FString::Printf(TEXT("SyntheticPlayers_%s"), *FDateTime::Now().ToString()));
+	PlayersFilename = BasePath + TEXT(".csv");
+	LabelsFilename = BasePath + TEXT("_labels.csv");
+
+	FFileHelper::SaveStringToFile(TEXT("PlayerID,ShotsFired,ShotsHit,Accuracy,AvgReactionTime,VarianceAcc,StdDevAcc,VarianceReactionTime,StdDevReactionTime,StdDevShotsHit\n"), *PlayersFilename);
+	FFileHelper::SaveStringToFile(TEXT("PlayerID,Cluster\n"), *LabelsFilename);
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("ShooterBot: simulating %d players, writing %s"), NumPlayers, *PlayersFilename);
+	return true;
+}
+
+void UShooterSessionRunner::BeginPlayer()
+{
+	CurrentArchetype = Population.SampleArchetype(PopulationStream);
+
+	AimBot->Profile.ReactionTime = CurrentArchetype.ReactionTime;
+	AimBot->Profile.ReactionTimeDeviation = CurrentArchetype.ReactionTimeDeviation;
+	AimBot->Profile.Accuracy = FShooterBotPopulation::SampleRoundAccuracy(CurrentArchetype, PopulationStream);
+
+	RoundAccuracies.Reset();
+	RoundHits.Reset();
+	RoundStartHits = 0;
+	RoundStartMisses = 0;
+}
+
+void UShooterSessionRunner::WritePlayerRecord(const AShooterTrainingSession* Session)
+{
+	// reaction time of every hit, paired with its spawn the same way the session does
+	double SumReactionTime = 0.0;
+	double SumSquaredReactionTime = 0.0;
+	const int32 NumReactionTimes = FMath::Min3(Session->SuccessfulHits, Session->TargetShotTimes.Num(), Session->TargetSpawnTimes.Num());
+
+	for (int32 i = 0; i < NumReactionTimes; ++i)
+	{
+		const double ReactionTime = Session->TargetShotTimes[i] - Session->TargetSpawnTimes[i];
+		SumReactionTime += ReactionTime;
+		SumSquaredReactionTime += ReactionTime * ReactionTime;
+	}
+
+	const double AvgReactionTime = NumReactionTimes > 0 ? SumReactionTime / NumReactionTimes : 0.0;
+	const double VarianceReactionTime = NumReactionTimes > 1 ? FMath::Max(0.0, (SumSquaredReactionTime - NumReactionTimes * AvgReactionTime * AvgReactionTime) / (NumReactionTimes - 1)) : 0.0;
+
+	// round to round spread of accuracy and hits, as sample variances
+	auto SampleVariance = [](const auto& Values)
+	{
+		if (Values.Num() < 2)
+		{
+			return 0.0;
+		}
+
+		double Mean = 0.0;
+		for (const auto Value : Values)
+		{
+			Mean += Value;
+		}
+		Mean /= Values.Num();
+
+		double Sum = 0.0;
+		for (const auto Value : Values)
+		{
+			Sum += FMath::Square(Value - Mean);
+		}
+		return Sum / (Values.Num() - 1);
+	};
+
+	const double VarianceAcc = SampleVariance(RoundAccuracies);
+	const double VarianceHits = SampleVariance(RoundHits);
+
+	const int32 ShotsFired = Session->SuccessfulHits + Session->MissedShots;
+	const double Accuracy = ShotsFired > 0 ? 100.0 * Session->SuccessfulHits / ShotsFired : 0.0;
+
+	// PlayerID,ShotsFired,ShotsHit,Accuracy,AvgReactionTime,VarianceAcc,StdDevAcc,VarianceReactionTime,StdDevReactionTime,StdDevShotsHit
+	const FString Record = FString::Printf(TEXT("%d,%d,%d,%.4f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n"),
+		PlayerIndex, ShotsFired, Session->SuccessfulHits, Accuracy, AvgReactionTime,
+		VarianceAcc, FMath::Sqrt(VarianceAcc), VarianceReactionTime, FMath::Sqrt(VarianceReactionTime), FMath::Sqrt(VarianceHits));
+
+	FFileHelper::SaveStringToFile(Record, *PlayersFilename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+	FFileHelper::SaveStringToFile(FString::Printf(TEXT("%d,%d\n"), PlayerIndex, CurrentArchetype.Cluster), *LabelsFilename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+void UShooterSessionRunner::OnRoundEnded(int32 Round)
+{
+	if (Benchmark)
+	{
+		Benchmark->OnRoundEnded(Round);
+	}
+
+	if (Population.IsEmpty() || !AimBot)
+	{
+		return;
+	}
+
+	// record the round for the player's variability features
+	if (const AShooterTrainingSession* Session = PrimarySession.Get())
+	{
+		const int32 Hits = Session->SuccessfulHits - RoundStartHits;
+		const int32 Shots = Hits + Session->MissedShots - RoundStartMisses;
+
+		if (Shots > 0)
+		{
+			RoundAccuracies.Add(100.0f * Hits / Shots);
+		}
+
+		RoundHits.Add(Hits);
+		RoundStartHits = Session->SuccessfulHits;
+		RoundStartMisses = Session->MissedShots;
+	}
+
+	// players don't hold the same accuracy every round
+	AimBot->Profile.Accuracy = FShooterBotPopulation::SampleRoundAccuracy(CurrentArchetype, PopulationStream);
+}
+
+TStatId UShooterSessionRunner::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSessionRunner, STATGROUP_Tickables);
+}
+
+void UShooterSessionRunner::OnSessionFinished(AShooterTrainingSession* Session)
+{
+	// move on to the next simulated player
+	if (Session == PrimarySession && !Population.IsEmpty() && AimBot)
+	{
+		WritePlayerRecord(Session);
+
+		if (++PlayerIndex < NumPlayers)
+		{
+			BeginPlayer();
+
+			// reset on the next tick, so the session finishes wrapping up first
+			GetWorld()->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(Session, [Session]()
+			{
+				Session->ResetSession();
+			}));
+
+			return;
+		}
+	}
+
+	// wait for the other sessions on this host
+	if (++NumSessionsFinished < NumSessions)
+	{
+		return;
+	}
+
+	const double SimulatedSeconds = GetWorld()->GetTimeSeconds() - SimulationStartTime;
+	const double WallSeconds = FPlatformTime::Seconds() - WallStartTime;
+	const double GameThreadMsPerMinute = SimulatedSeconds > 0.0 ? GameThreadSeconds * 1000.0 / (SimulatedSeconds / 60.0) : 0.0;
+
+	// a core keeps up in realtime as long as a simulated minute takes less than a minute of game thread time
+	const double SessionsPerCore = GameThreadMsPerMinute > 0.0 ? 60000.0 * NumSessions / GameThreadMsPerMinute : 0.0;
+
+	// FrameStats,Frames,SimulatedSeconds,WallSeconds,GameThreadMsPerSimulatedMinute,Sessions,SessionsPerCore,FrameTime p50/p90/p95/p99/max,GameThread p50/p90/p95/p99/max
+	TStringBuilder<256> Line;
+	Line.Appendf(TEXT("FrameStats,%llu,%.2f,%.2f,%.2f,%d,%.2f"), NumFrames, SimulatedSeconds, WallSeconds, GameThreadMsPerMinute, NumSessions, SessionsPerCore);
+	AShooterTrainingSession::AppendQuantiles(Line, FrameTimes);
+	AShooterTrainingSession::AppendQuantiles(Line, GameThreadTimes);
+
+	if (AShooterTrainingSession* LogSession = PrimarySession.Get())
+	{
+		LogSession->GetSessionLog().WriteLine(Line);
+		LogSession->GetSessionLog().Flush();
+	}
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("ShooterBot: session finished. %s"), Line.ToString());
+	UE_LOG(LogShootingGrounds, Display, TEXT("ShooterBot: %.2f ms of game thread time per simulated minute, %.1fx realtime, %.1f sessions per core"),
+		GameThreadMsPerMinute, WallSeconds > 0.0 ? SimulatedSeconds / WallSeconds : 0.0, SessionsPerCore);
+
+	// a failed benchmark exits with an error code so automated runs can catch regressions
+	bool bWithinBudget = true;
+
+	if (Benchmark)
+	{
+		const FString BasePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"), FString::Printf(TEXT("Benchmark_%s"), *FDateTime::Now().ToString()));
+		bWithinBudget = Benchmark->Finish(BasePath);
+		Benchmark.Reset();
+
+		UE_LOG(LogShootingGrounds, Display, TEXT("ShooterBot: benchmark %s, results in %s.json"), bWithinBudget ? TEXT("passed") : TEXT("FAILED"), *BasePath);
+	}
+
+	FPlatformMisc::RequestExitWithStatus(false, bWithinBudget ? 0 : 1, TEXT("ShooterSessionRunner"));
+}
@@ -0,0 +1,222 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterQuantileSketch.h"
+#include "ShooterBenchmark.h"
+#include "ShooterBotPopulation.h"
+#include "ShooterSessionRunner.generated.h"
+
+class AShooterGameMode;
+class AShooterNPC;
+class AShooterProjectile;
+class AShooterTrainingSession;
+class UShooterAimBotComponent;
+class UShooterRoundConfig;
+
+/**
+ *  Plays a full training session without a human player, for automated and headless runs
+ *  Only created when -ShooterBot is on the command line, for example:
+ *
+ *  UnrealEditor-Cmd ShootingGrounds.uproject <Map> -game -nullrhi -unattended -ShooterBot -ShooterRounds=3
+ *
+ *  Optional arguments:
+ *  -ShooterRounds=N -ShooterRoundLength=Seconds override the round config
+ *  -BotReaction=Seconds -BotReactionDev=Seconds -BotAccuracy=[0,1] -BotSeed=N tune the aim bot
+ *  -BotWeapon=/Path/To/Weapon.Weapon_C grants a weapon if the pawn starts without one
+ *  -ShooterPopulation=outputs/full_clusters_k3_centroids.csv -ShooterPlayers=N plays N simulated players back to back,
+ *  each with an aim model sampled from a cluster centroid. Every player gets their own session log, a row in
+ *  Saved/Telemetry/SyntheticPlayers_<date>.csv in the player modeling input format, and their true cluster in the
+ *  matching _labels.csv. Add -benchmark -fps=60 to simulate faster than realtime
+ *  -ShooterSessions=N hosts N isolated sessions in this process, each played by its own simulated player, and reports
+ *  the game thread cost per session as sessions per core. Add -server for a dedicated server, which always isolates sessions.
+ *  Simulated players live on the server, so the figure leaves out replication and RPCs. Size servers from runs with
+ *  real clients connected over loopback
+ *  -ShooterBenchmark checks the gameplay hot paths against the configured budgets, writes the results to
+ *  Saved/Telemetry/Benchmark_<date>.json and .csv and exits with a non zero code if any budget is exceeded or any
+ *  budgeted path wasn't measured. The weapons are hitscan, so the benchmark keeps its own projectiles in flight,
+ *  stepping their number up and down to fit their cost
+ *  -ShooterNPCs=N spawns N NPCs of the configured class on a grid around the player start. The benchmark steps the
+ *  number of NPCs in play up and down by taking some out of play, to fit the game thread cost per NPC. NPC steps are
+ *  a whole projectile cycle long, so the two fits don't pick up each other's cost. Runs at 50, 200 and 500 NPCs show
+ *  whether that cost holds up
+ *  -ShooterCrowd=N adds N crowd NPCs around the player start. They're Mass entities until they come near a player
+ *
+ *  Rounds start on their own and the player pawn is driven by an aim bot, so the session log contains the
+ *  usual shot, spawn and summary records. Frame time distributions and the game thread cost per simulated
+ *  minute are appended at the end, and the process exits when the session is finished
+ */
+UCLASS(Config=Game)
+class SHOOTINGGROUNDS_API UShooterSessionRunner : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Aim bot driving the player */
+	UPROPERTY(Transient)
+	TObjectPtr<UShooterAimBotComponent> AimBot;
+
+	/** Aim bots driving the simulated players of the other sessions */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UShooterAimBotComponent>> SimulatedAimBots;
+
+	/** Session played by the main aim bot. Population and benchmark round stats come from it */
+	TWeakObjectPtr<AShooterTrainingSession> PrimarySession;
+
+	/** Number of sessions hosted in this process */
+	int32 NumSessions = 1;
+
+	/** Number of sessions that played all their rounds */
+	int32 NumSessionsFinished = 0;
+
+	/** Round config built from the command line, if any */
+	UPROPERTY(Transient)
+	TObjectPtr<UShooterRoundConfig> RunConfig;
+
+	/** Budgets for the benchmark mode. Set them under [/Script/ShootingGrounds.ShooterSessionRunner] in DefaultGame.ini */
+	UPROPERTY(Config)
+	FShooterPerfBudgets Budgets;
+
+	/** NPC spawned by -ShooterNPCs. Set it under [/Script/ShootingGrounds.ShooterSessionRunner] in DefaultGame.ini */
+	UPROPERTY(Config)
+	TSoftClassPtr<AShooterNPC> NPCClass;
+
+	/** Distance between the NPCs spawned by -ShooterNPCs, in cm */
+	UPROPERTY(Config)
+	float NPCSpacing = 400.0f;
+
+	/** Radius around the player start the -ShooterCrowd NPCs are spread over, in cm */
+	UPROPERTY(Config)
+	float CrowdRadius = 20000.0f;
+
+	/** Projectile launched by the benchmark. Set it under [/Script/ShootingGrounds.ShooterSessionRunner] in DefaultGame.ini */
+	UPROPERTY(Config)
+	TSoftClassPtr<AShooterProjectile> BenchmarkProjectileClass;
+
+	/** Most projectiles the benchmark keeps in flight */
+	UPROPERTY(Config)
+	int32 BenchmarkProjectiles = 1000;
+
+	/** Time the benchmark holds each projectile count for, in seconds */
+	UPROPERTY(Config)
+	float BenchmarkProjectileStepTime = 2.0f;
+
+	/** Loaded benchmark projectile class */
+	UPROPERTY(Transient)
+	TSubclassOf<AShooterProjectile> ProjectileClass;
+
+	/** Location the benchmark projectiles are launched from */
+	FVector ProjectileOrigin = FVector::ZeroVector;
+
+	/** NPCs spawned by -ShooterNPCs, stepped in and out of play by the benchmark */
+	TArray<TWeakObjectPtr<AShooterNPC>> BenchmarkNPCs;
+
+	/** Benchmark in progress, if requested */
+	TUniquePtr<FShooterBenchmark> Benchmark;
+
+	/** Archetypes for simulated players, if a population was requested */
+	FShooterBotPopulation Population;
+
+	/** Archetype of the simulated player currently playing */
+	FShooterBotArchetype CurrentArchetype;
+
+	/** Random stream for the population sampling */
+	FRandomStream PopulationStream;
+
+	/** Number of simulated players to run */
+	int32 NumPlayers = 1;
+
+	/** Index of the simulated player currently playing */
+	int32 PlayerIndex = 0;
+
+	/** Accuracy per round for the current player, in percent */
+	TArray<float> RoundAccuracies;
+
+	/** Hits per round for the current player */
+	TArray<int32> RoundHits;
+
+	/** Session hit and miss counters at the start of the current round */
+	int32 RoundStartHits = 0;
+	int32 RoundStartMisses = 0;
+
+	/** Output file for the simulated player features */
+	FString PlayersFilename;
+
+	/** Output file for the simulated player ground truth clusters */
+	FString LabelsFilename;
+
+	/** Frame time distribution */
+	FShooterQuantileSketch FrameTimes;
+
+	/** Game thread time distribution */
+	FShooterQuantileSketch GameThreadTimes;
+
+	/** Total game thread time since the session started, in seconds */
+	double GameThreadSeconds = 0.0;
+
+	/** World time when the session started */
+	double SimulationStartTime = 0.0;
+
+	/** Wall clock time when the session started */
+	double WallStartTime = 0.0;
+
+	/** Number of frames since the session started */
+	uint64 NumFrames = 0;
+
+public:
+
+	/** Returns true if a headless bot session was requested on the command line */
+	static bool IsRequested();
+
+	/**
+	 *  Spawns NPCs of the configured class on a grid around a player's start, so they end up at a range of distances from them.
+	 *  Shared with the replay player, so recordings made with NPCs around can be played back with them. Returns the spawned NPCs
+	 */
+	static TArray<AShooterNPC*> SpawnNPCs(AShooterGameMode* GameMode, APlayerController* PlayerController, int32 Count);
+
+	//~Begin UWorldSubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	//~End UWorldSubsystem interface
+
+	//~Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End FTickableGameObject interface
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Builds a round config from the command line overrides, or returns nullptr if there are none */
+	UShooterRoundConfig* CreateRunConfig(const AShooterGameMode* GameMode);
+
+	/** Adds an aim bot to a player, configured from the command line. Seeded bots get a different seed per session */
+	UShooterAimBotComponent* AttachAimBot(APlayerController* PlayerController, int32 SessionIndex);
+
+	/** Tops up the benchmark projectiles to the count for the current step */
+	void UpdateBenchmarkProjectiles();
+
+	/** Activates or deactivates the spawned NPCs to match the count for the current step */
+	void UpdateBenchmarkNPCs();
+
+	/** Loads the population and opens its output files. Returns false if no population was requested */
+	bool InitPopulation();
+
+	/** Samples the next simulated player and sets up the aim bot for them */
+	void BeginPlayer();
+
+	/** Writes the finished player's features and ground truth */
+	void WritePlayerRecord(const AShooterTrainingSession* Session);
+
+	/** Collects per round stats for the current player and the benchmark */
+	void OnRoundEnded(int32 Round);
+
+	/** Moves on to the next simulated player, or writes the frame statistics and exits once every session is done */
+	void OnSessionFinished(AShooterTrainingSession* Session);
+};
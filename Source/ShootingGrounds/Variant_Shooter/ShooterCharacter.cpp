@@ -11,7 +11,9 @@
 #include "Engine/World.h"
 #include "Camera/CameraComponent.h"
 #include "TimerManager.h"
+#include "HAL/PlatformTime.h"
 #include "ShooterGameMode.h"
+#include "ShooterPlayerController.h"
 
 AShooterCharacter::AShooterCharacter()
 {
@@ -59,6 +61,32 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 
 }
 
+void AShooterCharacter::DoAim(float Yaw, float Pitch)
+{
+	// look input is gated between rounds
+	AShooterTrainingSession* Session = GetTrainingSession();
+
+	if (Session && !Session->IsCombatInputAllowed())
+	{
+		return;
+	}
+
+	// record the aim input for trajectory analysis, as the individual mouse moves behind it if we have them
+	if (!RecordRawMouseSamples(Yaw, Pitch))
+	{
+		AimHistory.Record(FPlatformTime::Cycles64(), Yaw, Pitch);
+	}
+
+	// replays only need the per frame input, which is what turns the view
+	if (Session)
+	{
+		Session->RecordAimInput(Yaw, Pitch);
+	}
+
+	// pass the aim input to the base class
+	Super::DoAim(Yaw, Pitch);
+}
+
 float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	// ignore if already dead
@@ -82,8 +110,124 @@ float AShooterCharacter::TakeDamage(float Damage, struct FDamageEvent const& Dam
 	return Damage;
 }
 
+AShooterTrainingSession* AShooterCharacter::GetTrainingSession() const
+{
+	// shooter players know their session on the server and on their own client
+	if (const AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(GetController()))
+	{
+		return PlayerController->GetTrainingSession();
+	}
+
+	// other controllers can only be looked up on the server
+	const AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	return GameMode ? GameMode->GetSessionFor(GetController()) : nullptr;
+}
+
+bool AShooterCharacter::IsCombatInputAllowed() const
+{
+	// only shooter training sessions gate input. Clients read the replicated round state
+	const AShooterTrainingSession* Session = GetTrainingSession();
+	return !Session || Session->IsCombatInputAllowed();
+}
+
+bool AShooterCharacter::RecordRawMouseSamples(float Yaw, float Pitch)
+{
+	const AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(GetController());
+	FShooterRawMouseSampler* Sampler = PlayerController ? PlayerController->GetRawMouseSampler() : nullptr;
+
+	if (!Sampler || !Sampler->HasSamples())
+	{
+		return false;
+	}
+
+	Sampler->ConsumeSamples(RawMouseSamples);
+
+	double SumX = 0.0;
+	double SumY = 0.0;
+
+	for (const FShooterRawMouseSample& Sample : RawMouseSamples)
+	{
+		SumX += Sample.DeltaX;
+		SumY += Sample.DeltaY;
+	}
+
+	// moves that don't account for the input on an axis mean it came from somewhere else, like a gamepad
+	if (FMath::IsNearlyZero(SumX) != FMath::IsNearlyZero(Yaw) || FMath::IsNearlyZero(SumY) != FMath::IsNearlyZero(Pitch))
+	{
+		return false;
+	}
+
+	// the input went through the mapping's sensitivity and inversion modifiers. Scale the moves to add up to it
+	const double YawScale = FMath::IsNearlyZero(SumX) ? 0.0 : Yaw / SumX;
+	const double PitchScale = FMath::IsNearlyZero(SumY) ? 0.0 : Pitch / SumY;
+
+	for (const FShooterRawMouseSample& Sample : RawMouseSamples)
+	{
+		AimHistory.Record(Sample.ArrivalCycles, static_cast<float>(Sample.DeltaX * YawScale), static_cast<float>(Sample.DeltaY * PitchScale));
+	}
+
+	return true;
+}
+
+bool AShooterCharacter::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	// players training in other sessions on the same host never see each other
+	const AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>();
+	if (GameMode && GameMode->IsHostingMultipleSessions() && IsPlayerControlled() && RealViewer != GetController())
+	{
+		return false;
+	}
+
+	return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+}
+
+bool AShooterCharacter::ResetForNewSession()
+{
+	// dead characters are already on their way out
+	if (CurrentHP <= 0.0f)
+	{
+		return false;
+	}
+
+	// stop shooting and moving
+	DoStopFiring();
+	GetCharacterMovement()->StopMovementImmediately();
+
+	// reset HP to max
+	CurrentHP = MaxHP;
+
+	// update the HUD
+	OnDamaged.Broadcast(1.0f);
+
+	// drop any aim samples from the previous session. The buffer allocation is kept
+	AimHistory.BeginSegment(FPlatformTime::Cycles64());
+
+	return true;
+}
+
 void AShooterCharacter::DoStartFiring()
 {
+	// firing is gated between rounds
+	AShooterTrainingSession* Session = GetTrainingSession();
+
+	if (Session && !Session->IsCombatInputAllowed())
+	{
+		return;
+	}
+
+	// shots are traced and scored by the server. It checks the gate again on its own state
+	if (!HasAuthority())
+	{
+		ServerStartFiring();
+		return;
+	}
+
+	// record the press before the shot goes off
+	if (Session)
+	{
+		Session->RecordFireInput(true);
+	}
+
 	// fire the current weapon
 	if (CurrentWeapon)
 	{
@@ -93,6 +237,17 @@ void AShooterCharacter::DoStartFiring()
 
 void AShooterCharacter::DoStopFiring()
 {
+	if (!HasAuthority())
+	{
+		ServerStopFiring();
+		return;
+	}
+
+	if (AShooterTrainingSession* Session = GetTrainingSession())
+	{
+		Session->RecordFireInput(false);
+	}
+
 	// stop firing the current weapon
 	if (CurrentWeapon)
 	{
@@ -100,6 +255,16 @@ void AShooterCharacter::DoStopFiring()
 	}
 }
 
+void AShooterCharacter::ServerStartFiring_Implementation()
+{
+	DoStartFiring();
+}
+
+void AShooterCharacter::ServerStopFiring_Implementation()
+{
+	DoStopFiring();
+}
+
 void AShooterCharacter::DoSwitchWeapon()
 {
 	// ensure we have at least two weapons two switch between
@@ -130,6 +295,29 @@ void AShooterCharacter::DoSwitchWeapon()
 	}
 }
 
+void AShooterCharacter::EquipWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass)
+{
+	AShooterWeapon* OwnedWeapon = FindWeaponOfType(WeaponClass);
+
+	// new weapons are equipped as they're added
+	if (!OwnedWeapon)
+	{
+		AddWeaponClass(WeaponClass);
+		return;
+	}
+
+	if (OwnedWeapon != CurrentWeapon)
+	{
+		if (CurrentWeapon)
+		{
+			CurrentWeapon->DeactivateWeapon();
+		}
+
+		CurrentWeapon = OwnedWeapon;
+		CurrentWeapon->ActivateWeapon();
+	}
+}
+
 void AShooterCharacter::AttachWeaponMeshes(AShooterWeapon* Weapon)
 {
 	const FAttachmentTransformRules AttachmentRule(EAttachmentRule::SnapToTarget, false);
@@ -5,9 +5,12 @@
 #include "CoreMinimal.h"
 #include "ShootingGroundsCharacter.h"
 #include "ShooterWeaponHolder.h"
+#include "ShooterAimHistory.h"
+#include "ShooterRawMouseSampler.h"
 #include "ShooterCharacter.generated.h"
 
 class AShooterWeapon;
+class AShooterTrainingSession;
 class UInputAction;
 class UInputComponent;
 class UPawnNoiseEmitterComponent;
@@ -73,6 +76,12 @@ protected:
 
 	FTimerHandle RespawnTimer;
 
+	/** Recent aim input samples, segmented per target by the game mode */
+	FShooterAimHistory AimHistory;
+
+	/** Scratch array for the raw mouse samples behind the current aim input */
+	TArray<FShooterRawMouseSample> RawMouseSamples;
+
 public:
 
 	/** Bullet count updated delegate */
@@ -99,6 +108,14 @@ protected:
 
 public:
 
+	/** Records the aim input before passing it to the controller. Also used by the aim bot */
+	virtual void DoAim(float Yaw, float Pitch) override;
+
+public:
+
+	/** Hides players from other training sessions when the game mode hosts multiple sessions */
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
 	/** Handle incoming damage */
 	virtual float TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
@@ -154,6 +171,23 @@ protected:
 	/** Returns true if the character already owns a weapon of the given class */
 	AShooterWeapon* FindWeaponOfType(TSubclassOf<AShooterWeapon> WeaponClass) const;
 
+	/** Returns the training session this character's player belongs to, if any */
+	AShooterTrainingSession* GetTrainingSession() const;
+
+	/** Returns true if fire and look input should be processed */
+	bool IsCombatInputAllowed() const;
+
+	/** Starts firing on the server, which runs the shot traces and scores them */
+	UFUNCTION(Server, Reliable)
+	void ServerStartFiring();
+
+	/** Stops firing on the server */
+	UFUNCTION(Server, Reliable)
+	void ServerStopFiring();
+
+	/** Records the raw mouse moves behind an aim input to the aim history. Returns false if the input didn't come from them */
+	bool RecordRawMouseSamples(float Yaw, float Pitch);
+
 	/** Called when this character's HP is depleted */
 	void Die();
 
@@ -163,4 +197,18 @@ protected:
 
 	/** Called from the respawn timer to destroy this character and force the PC to respawn */
 	void OnRespawn();
+
+public:
+
+	/** Returns the aim input history */
+	FShooterAimHistory& GetAimHistory() { return AimHistory; }
+
+	/** Restores HP and clears the aim history for a new session. Returns false if the character is dead and needs a respawn instead */
+	bool ResetForNewSession();
+
+	/** Returns the currently equipped weapon, if any */
+	AShooterWeapon* GetCurrentWeapon() const { return CurrentWeapon; }
+
+	/** Switches to the owned weapon of the given class, or adds one if there is none */
+	void EquipWeaponClass(const TSubclassOf<AShooterWeapon>& WeaponClass);
 };
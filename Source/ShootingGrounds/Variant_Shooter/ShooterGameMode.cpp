@@ -3,194 +3,235 @@
 
 #include "Variant_Shooter/ShooterGameMode.h"
 #include "ShooterUI.h"
+#include "ShooterRoundConfig.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 
-void AShooterGameMode::BeginPlay()
+double AShooterGameMode::ReloadStartTime = 0.0;
+
+void AShooterGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
 {
-	Super::BeginPlay();
+    Super::InitGame(MapName, Options, ErrorMessage);
 
-	// Set timer to end level in 60 seconds
-    // GetWorld()->GetTimerManager().SetTimer(
-    //     LevelEndTimerHandle,
-    //     this,
-    //     &AShooterGameMode::HandleLevelEnd,
-    //     60.0f,
-    //     false
-    // );
+    // a dedicated server is only worth running if it hosts many players
+    if (GetNetMode() == NM_DedicatedServer || FParse::Param(FCommandLine::Get(), TEXT("ShooterMultiSession")))
+    {
+        bHostMultipleSessions = true;
+    }
+}
 
-    // Initialize PlayerController
-    PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+void AShooterGameMode::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // were we started by a session reload?
+    if (ReloadStartTime > 0.0)
+    {
+        const double Milliseconds = (FPlatformTime::Seconds() - ReloadStartTime) * 1000.0;
 
-    // create the UI
-    ShooterUI = CreateWidget<UShooterUI>(UGameplayStatics::GetPlayerController(GetWorld(), 0), ShooterUIClass);
-    ShooterUI->AddToViewport(0);
-    ShooterUI->BP_ShowStartRoundButton();
+        for (AShooterTrainingSession* Session : Sessions)
+        {
+            Session->LogResetTime(TEXT("Reload"), Milliseconds);
+        }
 
-    DisablePlayerInput();
-    // StartRound();
+        ReloadStartTime = 0.0;
+    }
 }
 
 AShooterGameMode::AShooterGameMode()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // the round flow is driven by the sessions' timers, so the game mode never ticks
+    PrimaryActorTick.bCanEverTick = false;
 }
 
-void AShooterGameMode::StartRound()
+void AShooterGameMode::PostLogin(APlayerController* NewPlayer)
 {
-    if (bWaitingForRoundStart)
-    {
-        EnablePlayerInput();
-        bWaitingForRoundStart = false;
-        TimeRemaining = 60.0f; // Reset timer for the round
-        GetWorld()->GetTimerManager().SetTimer(
-        LevelEndTimerHandle,
-        this,
-        &AShooterGameMode::HandleLevelEnd,
-        60.0f,
-        false
-        );
-
-        if (ShooterUI)
-        {
-            ShooterUI->BP_HideStartRoundButton();
-        }
+    Super::PostLogin(NewPlayer);
 
-        UE_LOG(LogTemp, Display, TEXT("Round %d started!"), CurrentRound);
+    CreateSession(NewPlayer);
+}
+
+void AShooterGameMode::Logout(AController* Exiting)
+{
+    // the session takes its private spawners and targets with it
+    if (AShooterTrainingSession* Session = GetSessionFor(Exiting))
+    {
+        Sessions.Remove(Session);
+        Session->Destroy();
     }
+
+    Super::Logout(Exiting);
 }
 
-void AShooterGameMode::HandleLevelEnd()
+AShooterTrainingSession* AShooterGameMode::CreateSession(APlayerController* NewPlayer)
 {
-    // Implement end-of-level logic here
-    UE_LOG(LogTemp, Display, TEXT("Round %d ended!"), CurrentRound);
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.ObjectFlags |= RF_Transient;
+    SpawnParams.bDeferConstruction = true;
 
-    if(CurrentRound < MaxRounds)
+    AShooterTrainingSession* Session = GetWorld()->SpawnActor<AShooterTrainingSession>(AShooterTrainingSession::StaticClass(), FTransform::Identity, SpawnParams);
+
+    if (Session)
     {
-        ++CurrentRound;
-        bWaitingForRoundStart = true;
-        //TimeRemaining = 60.0f; // Reset timer for next round
+        // bind the player before the session begins play
+        Session->InitSession(NewPlayer, NextSessionIndex++, bAutoStartRounds);
+        Session->FinishSpawning(FTransform::Identity);
 
-        if (ShooterUI)
-        {
-            ShooterUI->BP_ShowStartRoundButton();
-        }
-        UE_LOG(LogTemp, Display, TEXT("Waiting for player to start Round %d"), CurrentRound);
+        Sessions.Add(Session);
+    }
 
-        DisablePlayerInput();
+    return Session;
+}
 
-        // GetWorld()->GetTimerManager().SetTimer(
-        //     LevelEndTimerHandle,
-        //     this,
-        //     &AShooterGameMode::HandleLevelEnd,
-        //     60.0f,
-        //     false
-        // );
+APlayerController* AShooterGameMode::SpawnSimulatedPlayer()
+{
+    // a controller without a connection or local player. It gets a player state, camera manager and pawn like any other
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.ObjectFlags |= RF_Transient;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
-        // UE_LOG(LogTemp, Display, TEXT("Starting Round %d"), CurrentRound);
-    }
-    else
+    APlayerController* NewPlayer = GetWorld()->SpawnActor<APlayerController>(PlayerControllerClass, FTransform::Identity, SpawnParams);
+
+    if (!NewPlayer)
     {
-        DisablePlayerInput();
+        return nullptr;
+    }
 
-        // Calculate and log accuracy
-        CalculateAccuracy();
+    ChangeName(NewPlayer, FString::Printf(TEXT("SimulatedPlayer%d"), NextSessionIndex), false);
+    RestartPlayer(NewPlayer);
+    CreateSession(NewPlayer);
 
-        // Calculate and log average spawn time
-        CalculateAverageSpawnTime();
-    }
-	// Optionally show a Game Over widget
-    // ShooterUI->ShowGameOver();
+    return NewPlayer;
 }
 
-void AShooterGameMode::CalculateAccuracy()
+AShooterTrainingSession* AShooterGameMode::GetSessionFor(const AController* Controller) const
 {
-    int32 TotalShots = SuccessfulHits + MissedShots;
-    if (TotalShots > 0)
+    for (AShooterTrainingSession* Session : Sessions)
     {
-        Accuracy = (static_cast<float>(SuccessfulHits) / static_cast<float>(TotalShots)) * 100.f;
+        if (Session && Controller && Session->GetPlayerController() == Controller)
+        {
+            return Session;
+        }
     }
-    else
+
+    return nullptr;
+}
+
+AShooterTrainingSession* AShooterGameMode::GetSessionForActor(const AActor* Actor) const
+{
+    // targets are owned by spawners, spawners by sessions, sessions and pawns by players
+    for (const AActor* Owner = Actor; Owner; Owner = Owner->GetOwner())
     {
-        Accuracy = 0.f;
+        // AI and their pawns don't play in a session, not even in the single session setup
+        const APawn* Pawn = Cast<APawn>(Owner);
+
+        if ((Pawn && !Pawn->IsPlayerControlled()) || (Owner->IsA<AController>() && !Owner->IsA<APlayerController>()))
+        {
+            return nullptr;
+        }
+
+        for (AShooterTrainingSession* Session : Sessions)
+        {
+            if (Session && (Session == Owner || Session->GetPlayerController() == Owner))
+            {
+                return Session;
+            }
+        }
     }
 
-    UE_LOG(LogTemp, Display, TEXT("Successful shots: %d"), SuccessfulHits);
-    UE_LOG(LogTemp, Display, TEXT("Missed shots: %d"), MissedShots);
-    UE_LOG(LogTemp, Display, TEXT("Total shots: %d"), SuccessfulHits + MissedShots);
-    UE_LOG(LogTemp, Display, TEXT("Player Accuracy: %.2f%%"), Accuracy);
+    // a single session owns the level actors, like the spawners and their targets
+    return bHostMultipleSessions ? nullptr : GetPrimarySession();
 }
 
-void AShooterGameMode::CalculateAverageSpawnTime()
+void AShooterGameMode::ResetSession()
 {
-    if (TargetSpawnTimes.Num() > 0 && TargetShotTimes.Num() > 0)
+    // zero the team scores and the UI
+    for (TPair<uint8, int32>& TeamScore : TeamScores)
     {
-        float TotalTime = 0.f;
+        TeamScore.Value = 0;
 
-        for (int32 i = 0; i < SuccessfulHits; ++i)
+        for (AShooterTrainingSession* Session : Sessions)
         {
-            TotalTime += (TargetShotTimes[i] - TargetSpawnTimes[i]);
+            if (UShooterUI* ShooterUI = Session->GetShooterUI())
+            {
+                ShooterUI->BP_UpdateScore(TeamScore.Key, 0);
+            }
         }
-
-        float AvgTime = TotalTime / static_cast<float>(SuccessfulHits);
-        UE_LOG(LogTemp, Display, TEXT("Total spawn time: %.2f"), TotalTime);
-        UE_LOG(LogTemp, Display, TEXT("Average Reaction Time: %.2f seconds"), AvgTime);
     }
-    else
+
+    for (AShooterTrainingSession* Session : Sessions)
     {
-        UE_LOG(LogTemp, Display, TEXT("No targets were spawned or shot."));
+        Session->ResetSession();
     }
 }
 
-void AShooterGameMode::IncrementTeamScore(uint8 TeamByte)
+void AShooterGameMode::ReloadSession()
 {
-	// retrieve the team score if any
-	int32 Score = 0;
-	if (int32* FoundScore = TeamScores.Find(TeamByte))
-	{
-		Score = *FoundScore;
-	}
+    // time the reload until the next game mode begins play
+    ReloadStartTime = FPlatformTime::Seconds();
 
-	// increment the score for the given team
-	++Score;
-	TeamScores.Add(TeamByte, Score);
-
-	// update the UI
-	ShooterUI->BP_UpdateScore(TeamByte, Score);
+    UGameplayStatics::OpenLevel(this, FName(*UGameplayStatics::GetCurrentLevelName(this)));
 }
 
-// Enable player input
-void AShooterGameMode::EnablePlayerInput()
+void AShooterGameMode::StartRound()
 {
-    if (PlayerController)
+    // only players with a screen on this machine can press the button
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
     {
-        PlayerController->SetPause(false);
-        PlayerController->bShowMouseCursor = false;
+        if (It->IsValid() && (*It)->IsLocalPlayerController() && (*It)->GetLocalPlayer())
+        {
+            StartRoundFor(It->Get());
+        }
     }
 }
 
-// Disable player input
-void AShooterGameMode::DisablePlayerInput()
+void AShooterGameMode::StartRoundFor(const AController* Controller)
 {
-    if (PlayerController)
+    if (AShooterTrainingSession* Session = GetSessionFor(Controller))
     {
-        PlayerController->SetPause(true);
-        PlayerController->bShowMouseCursor = true;
+        Session->StartRound();
     }
 }
 
-void AShooterGameMode::Tick(float DeltaSeconds)
+const UShooterRoundConfig* AShooterGameMode::GetRoundConfig() const
 {
-    Super::Tick(DeltaSeconds);
+    return RoundConfig ? RoundConfig.Get() : GetDefault<UShooterRoundConfig>();
+}
 
-    if (TimeRemaining > 0.f)
-    {
-        TimeRemaining -= DeltaSeconds;
-        float SecondsLeft = FMath::Max(0.f, TimeRemaining);
+void AShooterGameMode::SetAutoStartRounds(bool bAutoStart)
+{
+    bAutoStartRounds = bAutoStart;
 
-        if(ShooterUI != nullptr)
-        {
-            ShooterUI->BP_UpdateTimer(SecondsLeft);
-        }
+    for (AShooterTrainingSession* Session : Sessions)
+    {
+        Session->SetAutoStartRounds(bAutoStart);
     }
 }
+
+void AShooterGameMode::IncrementTeamScore(uint8 TeamByte)
+{
+	// retrieve the team score if any
+	int32 Score = 0;
+	if (int32* FoundScore = TeamScores.Find(TeamByte))
+	{
+		Score = *FoundScore;
+	}
+
+	// increment the score for the given team
+	++Score;
+	TeamScores.Add(TeamByte, Score);
+
+	// update the UI
+	for (AShooterTrainingSession* Session : Sessions)
+	{
+		if (UShooterUI* ShooterUI = Session->GetShooterUI())
+		{
+			ShooterUI->BP_UpdateScore(TeamByte, Score);
+		}
+	}
+}
@@ -4,80 +4,128 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "ShooterTrainingSession.h"
 #include "ShooterGameMode.generated.h"
 
 class UShooterUI;
+class UShooterRoundConfig;
 
 /**
  *  Simple GameMode for a first person shooter game
- *  Manages game UI
+ *  Hosts a training session for every player that joins
  *  Keeps track of team scores
  */
 UCLASS(abstract)
 class SHOOTINGGROUNDS_API AShooterGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
 protected:
 
 	/** Type of UI widget to spawn */
 	UPROPERTY(EditAnywhere, Category="Shooter")
 	TSubclassOf<UShooterUI> ShooterUIClass;
 
-	/** Pointer to the UI widget */
-	TObjectPtr<UShooterUI> ShooterUI;
+	/** Round count, durations and drills for the session. Uses the config class defaults if unset */
+	UPROPERTY(EditAnywhere, Category="Shooter")
+	TObjectPtr<UShooterRoundConfig> RoundConfig;
+
+	/** If true, rounds start on their own instead of waiting for the start button. Used by the headless session runner */
+	UPROPERTY(EditAnywhere, Category="Shooter")
+	bool bAutoStartRounds = false;
+
+	/**
+	 *  If true, every player gets an isolated session with private instances of the level's target spawners.
+	 *  Always on for dedicated servers, or with -ShooterMultiSession on the command line
+	 */
+	UPROPERTY(EditAnywhere, Category="Shooter")
+	bool bHostMultipleSessions = false;
+
+	/** Training sessions in progress, one per player */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AShooterTrainingSession>> Sessions;
+
+	/** Index for the next session. Never reused, so concurrent sessions keep their log files apart */
+	int32 NextSessionIndex = 0;
 
 	/** Map of scores by team ID */
 	TMap<uint8, int32> TeamScores;
 
+	/** Platform time when a session reload was requested, or zero. Survives the level reload so the load can be timed */
+	static double ReloadStartTime;
+
 protected:
 
+	/** Picks up the multi session switches before any player joins */
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
 	/** Gameplay initialization */
 	virtual void BeginPlay() override;
 
-	virtual void Tick(float DeltaSeconds) override;
+	/** Starts a training session for the new player */
+	virtual void PostLogin(APlayerController* NewPlayer) override;
 
+	/** Ends the leaving player's training session */
+	virtual void Logout(AController* Exiting) override;
+
+	/** Starts the next round for the players local to the server if they're waiting for it. Remote players use their controller's RequestStartRound */
 	UFUNCTION(BlueprintCallable, Category="Shooter")
 	void StartRound();
 
-	UFUNCTION()
-	void HandleLevelEnd();
+	/** Spawns and initializes the training session for a player */
+	AShooterTrainingSession* CreateSession(APlayerController* NewPlayer);
 
-	UFUNCTION()
-	void CalculateAccuracy();
-	
-	UFUNCTION()
-	void CalculateAverageSpawnTime();
+public:
 
-	UFUNCTION()
-	void EnablePlayerInput();
+	AShooterGameMode();
 
-	UFUNCTION()
-	void DisablePlayerInput();
+	/** Restores every session, the team scores and the UI to their initial state without reloading the level */
+	UFUNCTION(Exec, BlueprintCallable, Category="Shooter")
+	void ResetSession();
 
-	APlayerController* PlayerController = nullptr;
+	/** Resets the session by reloading the level. Kept to compare against ResetSession */
+	UFUNCTION(Exec, BlueprintCallable, Category="Shooter")
+	void ReloadSession();
 
-	FTimerHandle LevelEndTimerHandle;
+	/** Starts the next round of the given player's session if it's waiting for it */
+	void StartRoundFor(const AController* Controller);
 
-	int32 CurrentRound = 1;
-	int32 MaxRounds = 3;
+	/** Returns the round config in use */
+	const UShooterRoundConfig* GetRoundConfig() const;
 
-	float TimeRemaining = 0.0f;
+	/** Overrides the round config. Only takes effect for rounds that haven't started yet */
+	void SetRoundConfig(UShooterRoundConfig* NewRoundConfig) { RoundConfig = NewRoundConfig; }
 
-	bool bWaitingForRoundStart = true;
+	/** Sets whether rounds start on their own for every session. Starts pending rounds right away */
+	void SetAutoStartRounds(bool bAutoStart);
 
-public:
+	/** Returns the UI widget class for local players */
+	TSubclassOf<UShooterUI> GetShooterUIClass() const { return ShooterUIClass; }
 
-	AShooterGameMode();
+	/** Returns true if every player gets an isolated session */
+	bool IsHostingMultipleSessions() const { return bHostMultipleSessions; }
+
+	/** Turns on isolated sessions. Only takes effect for sessions that haven't begun play yet */
+	void SetHostMultipleSessions(bool bMultipleSessions) { bHostMultipleSessions = bMultipleSessions; }
+
+	/** Spawns a server side player with its own pawn and session, standing in for a remote client */
+	APlayerController* SpawnSimulatedPlayer();
+
+	/** Returns all sessions in progress */
+	const TArray<TObjectPtr<AShooterTrainingSession>>& GetSessions() const { return Sessions; }
+
+	/** Returns the first player's session, or nullptr if nobody has joined */
+	AShooterTrainingSession* GetPrimarySession() const { return Sessions.Num() > 0 ? Sessions[0].Get() : nullptr; }
 
-	// Accuracy tracking
-	int32 SuccessfulHits = 0;
-	int32 MissedShots = 0;
-	float Accuracy = 0.f;
+	/** Returns the session of the given player, or nullptr if they don't have one */
+	AShooterTrainingSession* GetSessionFor(const AController* Controller) const;
 
-	// Average reaction time tracking
-	TArray<float> TargetSpawnTimes;
-	TArray<float> TargetShotTimes;
+	/**
+	 *  Returns the session an actor belongs to by walking up its owners, so it works for players, their pawns and weapons,
+	 *  and for spawners and their targets. Unowned actors belong to the primary session unless the host runs multiple sessions.
+	 *  Pawns that aren't player controlled, like NPCs, and AI controllers and the actors they own never belong to a session
+	 */
+	AShooterTrainingSession* GetSessionForActor(const AActor* Actor) const;
 
 	/** Increases the score for the given team */
 	void IncrementTeamScore(uint8 TeamByte);
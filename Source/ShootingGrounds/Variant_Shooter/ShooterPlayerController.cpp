@@ -8,16 +8,19 @@
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerStart.h"
 #include "ShooterCharacter.h"
+#include "ShooterGameMode.h"
 #include "ShooterBulletCounterUI.h"
+#include "ShooterRawMouseSampler.h"
 #include "ShootingGrounds.h"
 #include "Widgets/Input/SVirtualJoystick.h"
+#include "Framework/Application/SlateApplication.h"
 
 void AShooterPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// only spawn touch controls on local player controllers
-	if (IsLocalPlayerController())
+	// only spawn touch controls on local player controllers. Simulated players on a server have no screen
+	if (IsLocalPlayerController() && GetLocalPlayer())
 	{
 		if (SVirtualJoystick::ShouldDisplayTouchInterface())
 		{
@@ -48,10 +51,41 @@ void AShooterPlayerController::BeginPlay()
 			UE_LOG(LogShootingGrounds, Error, TEXT("Could not spawn bullet counter widget."));
 
 		}
+
+		// catch every mouse move ahead of the per frame accumulation
+		if (bSampleRawMouse && FSlateApplication::IsInitialized())
+		{
+			RawMouseSampler = MakeShared<FShooterRawMouseSampler>();
+			FSlateApplication::Get().RegisterInputPreProcessor(RawMouseSampler);
+		}
 		
 	}
 }
 
+void AShooterPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	if (RawMouseSampler && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().UnregisterInputPreProcessor(RawMouseSampler);
+	}
+
+	RawMouseSampler.Reset();
+}
+
+void AShooterPlayerController::PlayerTick(float DeltaTime)
+{
+	// input is processed in here, which is where the pawn consumes the samples
+	Super::PlayerTick(DeltaTime);
+
+	// anything left over was moved outside of aiming, like in a menu or between rounds
+	if (RawMouseSampler)
+	{
+		RawMouseSampler->DiscardSamples();
+	}
+}
+
 void AShooterPlayerController::SetupInputComponent()
 {
 	// only add IMCs for local player controllers
@@ -102,7 +136,10 @@ void AShooterPlayerController::OnPossess(APawn* InPawn)
 void AShooterPlayerController::OnPawnDestroyed(AActor* DestroyedActor)
 {
 	// reset the bullet counter HUD
-	BulletCounterUI->BP_UpdateBulletCounter(0, 0);
+	if (BulletCounterUI)
+	{
+		BulletCounterUI->BP_UpdateBulletCounter(0, 0);
+	}
 
 	// find the player start
 	TArray<AActor*> ActorList;
@@ -140,3 +177,17 @@ void AShooterPlayerController::OnPawnDamaged(float LifePercent)
 		BulletCounterUI->BP_Damaged(LifePercent);
 	}
 }
+
+void AShooterPlayerController::RequestStartRound()
+{
+	// runs right away on the server, or goes over the connection from a client
+	ServerStartRound();
+}
+
+void AShooterPlayerController::ServerStartRound_Implementation()
+{
+	if (AShooterGameMode* GameMode = GetWorld()->GetAuthGameMode<AShooterGameMode>())
+	{
+		GameMode->StartRoundFor(this);
+	}
+}
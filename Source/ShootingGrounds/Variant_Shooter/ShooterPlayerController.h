@@ -9,6 +9,8 @@
 class UInputMappingContext;
 class AShooterCharacter;
 class UShooterBulletCounterUI;
+class FShooterRawMouseSampler;
+class AShooterTrainingSession;
 
 /**
  *  Simple PlayerController for a first person shooter game
@@ -52,11 +54,27 @@ protected:
 	/** Pointer to the bullet counter UI widget */
 	TObjectPtr<UShooterBulletCounterUI> BulletCounterUI;
 
+	/** If true, local players record every mouse move to the aim history instead of the per frame sum */
+	UPROPERTY(EditAnywhere, Category="Input|Aim Sampling")
+	bool bSampleRawMouse = true;
+
+	/** Collects mouse moves between frames. Only set for local players */
+	TSharedPtr<FShooterRawMouseSampler> RawMouseSampler;
+
+	/** This player's training session. Set on the server and on the owning client */
+	TWeakObjectPtr<AShooterTrainingSession> TrainingSession;
+
 protected:
 
 	/** Gameplay Initialization */
 	virtual void BeginPlay() override;
 
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Drops the mouse samples this frame's input didn't consume */
+	virtual void PlayerTick(float DeltaTime) override;
+
 	/** Initialize input bindings */
 	virtual void SetupInputComponent() override;
 
@@ -74,4 +92,23 @@ protected:
 	/** Called when the possessed pawn is damaged */
 	UFUNCTION()
 	void OnPawnDamaged(float LifePercent);
+
+	/** Starts the next round of this player's session on the server */
+	UFUNCTION(Server, Reliable)
+	void ServerStartRound();
+
+public:
+
+	/** Returns the raw mouse sampler, if this player has one */
+	FShooterRawMouseSampler* GetRawMouseSampler() const { return RawMouseSampler.Get(); }
+
+	/** Asks the server to start the next round of this player's session. Bind the UI start button to this */
+	UFUNCTION(BlueprintCallable, Category="Shooter")
+	void RequestStartRound();
+
+	/** Sets this player's training session */
+	void SetTrainingSession(AShooterTrainingSession* Session) { TrainingSession = Session; }
+
+	/** Returns this player's training session, or nullptr if it hasn't been created or replicated yet */
+	AShooterTrainingSession* GetTrainingSession() const { return TrainingSession.Get(); }
 };
@@ -0,0 +1,17 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterRoundConfig.h"
+
+UShooterRoundConfig::UShooterRoundConfig()
+{
+	// default to three one minute rounds
+	Rounds.SetNum(3);
+}
+
+const FShooterRoundDefinition& UShooterRoundConfig::GetRound(int32 RoundNumber) const
+{
+	static const FShooterRoundDefinition DefaultRound;
+
+	return Rounds.IsValidIndex(RoundNumber - 1) ? Rounds[RoundNumber - 1] : DefaultRound;
+}
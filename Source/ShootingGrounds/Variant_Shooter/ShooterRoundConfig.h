@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShooterRoundConfig.generated.h"
+
+/**
+ *  Type of aim drill run during a round
+ */
+UENUM(BlueprintType)
+enum class EShooterDrillType : uint8
+{
+	/** A single static target that respawns at a random location when hit */
+	Flick
+};
+
+/**
+ *  Settings for a single round of a training session
+ */
+USTRUCT(BlueprintType)
+struct FShooterRoundDefinition
+{
+	GENERATED_BODY()
+
+	/** Length of the round */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Round", meta = (ClampMin = 1, ClampMax = 3600, Units = "s"))
+	float Duration = 60.0f;
+
+	/** Drill to run during the round */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Round")
+	EShooterDrillType DrillType = EShooterDrillType::Flick;
+
+	/** Seed for the round's target spawn schedule. If zero, a random seed is picked */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Round")
+	int32 SpawnSeed = 0;
+
+	/** Assets streamed in during the break before this round, so they're resident when it starts */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Round")
+	TArray<TSoftObjectPtr<UObject>> PreloadAssets;
+};
+
+/**
+ *  Data driven round flow for a shooter training session
+ */
+UCLASS(BlueprintType)
+class SHOOTINGGROUNDS_API UShooterRoundConfig : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Rounds to play, in order */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Rounds")
+	TArray<FShooterRoundDefinition> Rounds;
+
+	/** Time between rounds before the next one starts on its own. If zero, waits for the player to start it */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Rounds", meta = (ClampMin = 0, ClampMax = 600, Units = "s"))
+	float IntermissionDuration = 0.0f;
+
+public:
+
+	/** Constructor */
+	UShooterRoundConfig();
+
+	/** Returns the number of rounds in the session */
+	int32 GetNumRounds() const { return Rounds.Num(); }
+
+	/** Returns the definition for a round. Round numbers start at 1 */
+	const FShooterRoundDefinition& GetRound(int32 RoundNumber) const;
+};
@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterSessionEvents.h"
+
+void FShooterShotEvent::SetAim(const FRotator& Aim)
+{
+	Yaw = FRotator::CompressAxisToShort(Aim.Yaw);
+	Pitch = FRotator::CompressAxisToShort(Aim.Pitch);
+}
+
+FRotator FShooterShotEvent::GetAim() const
+{
+	return FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), 0.0f);
+}
+
+bool FShooterShotEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	ImpactPoint.NetSerialize(Ar, Map, bOutSuccess);
+	Ar << Yaw;
+	Ar << Pitch;
+
+	// most shots are less than 128 ms apart, which packs into a single byte
+	Ar.SerializeIntPacked(DeltaMs);
+
+	uint8 HitBit = bHit ? 1 : 0;
+	Ar.SerializeBits(&HitBit, 1);
+	bHit = HitBit != 0;
+
+	return true;
+}
+
+bool FShooterSpawnEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Location.NetSerialize(Ar, Map, bOutSuccess);
+	Ar.SerializeIntPacked(DeltaMs);
+
+	return true;
+}
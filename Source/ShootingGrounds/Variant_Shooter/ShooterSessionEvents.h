@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "ShooterSessionEvents.generated.h"
+
+/** Number of slots in each replicated event ring. Covers more events than fit between two net updates at any fire rate */
+static constexpr int32 ShooterEventRingSize = 16;
+
+/**
+ *  Compact record of a shot, replicated to the shooting player
+ *  Serialized as a quantized impact point, 16 bit view angles, a variable length
+ *  time delta from the previous shot and a single hit bit
+ */
+USTRUCT()
+struct FShooterShotEvent
+{
+	GENERATED_BODY()
+
+	/** Where the shot landed, to the nearest centimeter */
+	UPROPERTY()
+	FVector_NetQuantize ImpactPoint = FVector::ZeroVector;
+
+	/** View yaw when the shot was fired, compressed to 16 bits */
+	UPROPERTY()
+	uint16 Yaw = 0;
+
+	/** View pitch when the shot was fired, compressed to 16 bits */
+	UPROPERTY()
+	uint16 Pitch = 0;
+
+	/** Milliseconds since the previous shot, or since the session started */
+	UPROPERTY()
+	uint32 DeltaMs = 0;
+
+	/** True if the shot hit a target */
+	UPROPERTY()
+	bool bHit = false;
+
+	/** Fills in the view angles from a rotation */
+	void SetAim(const FRotator& Aim);
+
+	/** Returns the view angles at the time of the shot */
+	FRotator GetAim() const;
+
+	/** Packs the event for replication */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterShotEvent> : public TStructOpsTypeTraitsBase2<FShooterShotEvent>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ *  Compact record of a target spawn, replicated to the session's player
+ *  Serialized as a quantized location and a variable length time delta from the previous spawn
+ */
+USTRUCT()
+struct FShooterSpawnEvent
+{
+	GENERATED_BODY()
+
+	/** Where the target spawned, to the nearest centimeter */
+	UPROPERTY()
+	FVector_NetQuantize Location = FVector::ZeroVector;
+
+	/** Milliseconds since the previous spawn, or since the session started */
+	UPROPERTY()
+	uint32 DeltaMs = 0;
+
+	/** Packs the event for replication */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterSpawnEvent> : public TStructOpsTypeTraitsBase2<FShooterSpawnEvent>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ *  Helpers for the delta compressed event timestamps
+ */
+struct FShooterEventTime
+{
+	/** Converts a time difference to whole milliseconds for an event delta */
+	static uint32 ToDeltaMs(double DeltaSeconds)
+	{
+		return static_cast<uint32>(FMath::Clamp(FMath::RoundToInt64(DeltaSeconds * 1000.0), 0ll, static_cast<int64>(MAX_uint32)));
+	}
+
+	/** Converts an event delta back to seconds */
+	static double FromDeltaMs(uint32 DeltaMs)
+	{
+		return DeltaMs / 1000.0;
+	}
+};
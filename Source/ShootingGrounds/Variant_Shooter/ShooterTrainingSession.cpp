@@ -0,0 +1,1103 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterTrainingSession.h"
+#include "ShooterGameMode.h"
+#include "ShooterUI.h"
+#include "ShooterRoundConfig.h"
+#include "ShooterCharacter.h"
+#include "ShooterPlayerController.h"
+#include "ShooterWeapon.h"
+#include "ShooterTrace.h"
+#include "TargetSpawner.h"
+#include "EngineUtils.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "TimerManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+AShooterTrainingSession::AShooterTrainingSession()
+{
+	// the round flow is driven by timers, so the session never ticks
+	PrimaryActorTick.bCanEverTick = false;
+
+	// only the session's own player gets its events
+	bReplicates = true;
+	bOnlyRelevantToOwner = true;
+	bAlwaysRelevant = false;
+
+	// frequent enough that the event rings never overflow between updates. Push model keeps idle updates cheap
+	SetNetUpdateFrequency(20.0f);
+}
+
+void AShooterTrainingSession::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_OwnerOnly;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterTrainingSession, RoundState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterTrainingSession, EventStreamStartTime, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterTrainingSession, ShotRing, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterTrainingSession, ShotSequence, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterTrainingSession, SpawnRing, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AShooterTrainingSession, SpawnSequence, Params);
+}
+
+void AShooterTrainingSession::InitSession(APlayerController* InPlayerController, int32 InSessionIndex, bool bInAutoStartRounds)
+{
+	PlayerController = InPlayerController;
+	SessionIndex = InSessionIndex;
+	bAutoStartRounds = bInAutoStartRounds;
+
+	// owned by the player so the spawners and targets below us are owned by them too
+	SetOwner(InPlayerController);
+
+	// the player's pawn finds its session through the controller, on the server and on the owning client
+	if (AShooterPlayerController* ShooterController = Cast<AShooterPlayerController>(InPlayerController))
+	{
+		ShooterController->SetTrainingSession(this);
+	}
+
+	// open the log now, since level spawners may report their first target before we begin play
+	OpenSessionLog();
+
+	// pick the seed for the spawn schedules. Replays override it before we begin play
+	SessionSeed = FMath::Rand();
+
+	// time the event streams from here
+	EventStreamStartTime = GetWorld()->GetTimeSeconds();
+	LastShotEventTime = EventStreamStartTime;
+	LastSpawnEventTime = EventStreamStartTime;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterTrainingSession, EventStreamStartTime, this);
+}
+
+void AShooterTrainingSession::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// on the owning client, the session only presents the server's round flow to its player
+	if (!HasAuthority())
+	{
+		PlayerController = Cast<APlayerController>(GetOwner());
+
+		if (AShooterPlayerController* ShooterController = Cast<AShooterPlayerController>(PlayerController))
+		{
+			ShooterController->SetTrainingSession(this);
+		}
+	}
+
+	// only local players get the UI. Clients don't have the game mode, so read the class off its defaults
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const AShooterGameMode* GameModeDefaults = GameState ? GameState->GetDefaultGameMode<AShooterGameMode>() : nullptr;
+
+	if (GameModeDefaults && PlayerController && PlayerController->GetLocalPlayer())
+	{
+		ShooterUI = CreateWidget<UShooterUI>(PlayerController, GameModeDefaults->GetShooterUIClass());
+
+		if (ShooterUI)
+		{
+			ShooterUI->AddToViewport(0);
+		}
+	}
+
+	if (!HasAuthority())
+	{
+		PresentRoundState();
+		return;
+	}
+
+	CreateSpawners();
+
+	// record the session from here, so the first round is prepared with the final seed
+	BeginReplay();
+
+	// wait for the player to start the first round
+	SetRoundState(EShooterRoundState::WaitingToStart);
+}
+
+void AShooterTrainingSession::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// stop the round clock
+	StopStateTimer();
+
+	// keep what was recorded of an unfinished session
+	SaveReplay();
+
+	// close the telemetry log
+	SessionLog.Close();
+
+	// private spawners leave with the session
+	for (ATargetSpawner* Spawner : Spawners)
+	{
+		if (IsValid(Spawner) && Spawner->GetOwner() == this)
+		{
+			Spawner->Destroy();
+		}
+	}
+
+	Spawners.Reset();
+}
+
+AShooterGameMode* AShooterTrainingSession::GetShooterGameMode() const
+{
+	return GetWorld() ? GetWorld()->GetAuthGameMode<AShooterGameMode>() : nullptr;
+}
+
+void AShooterTrainingSession::CreateSpawners()
+{
+	// spawners owned by another session are that session's private instances
+	TArray<ATargetSpawner*> LevelSpawners;
+
+	for (TActorIterator<ATargetSpawner> It(GetWorld()); It; ++It)
+	{
+		if (!It->GetOwner())
+		{
+			LevelSpawners.Add(*It);
+		}
+	}
+
+	// a single session uses the level's spawners directly
+	const AShooterGameMode* GameMode = GetShooterGameMode();
+
+	if (!GameMode || !GameMode->IsHostingMultipleSessions())
+	{
+		Spawners.Append(LevelSpawners);
+		return;
+	}
+
+	// otherwise the level's spawners are templates for our own instances
+	for (ATargetSpawner* Template : LevelSpawners)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Template = Template;
+		SpawnParams.Owner = this;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		if (ATargetSpawner* Spawner = GetWorld()->SpawnActor<ATargetSpawner>(Template->GetClass(), Template->GetActorTransform(), SpawnParams))
+		{
+			Spawners.Add(Spawner);
+		}
+	}
+}
+
+void AShooterTrainingSession::PrepareNextRound()
+{
+	const FShooterRoundDefinition& NextRound = GetRoundConfig()->GetRound(CurrentRound);
+
+	// fill the target pools and build the spawn schedules in the background, for the spawners the round's drill uses
+	for (int32 SpawnerIndex = 0; SpawnerIndex < Spawners.Num(); ++SpawnerIndex)
+	{
+		if (IsValid(Spawners[SpawnerIndex]) && Spawners[SpawnerIndex]->GetDrillType() == NextRound.DrillType)
+		{
+			Spawners[SpawnerIndex]->PrepareRound(GetSpawnSeed(SpawnerIndex));
+		}
+	}
+
+	// stream in the next round's assets. The handle keeps them resident through the round
+	TArray<FSoftObjectPath> AssetPaths;
+
+	for (const TSoftObjectPtr<UObject>& Asset : NextRound.PreloadAssets)
+	{
+		if (!Asset.IsNull())
+		{
+			AssetPaths.Add(Asset.ToSoftObjectPath());
+		}
+	}
+
+	PreloadHandle = AssetPaths.Num() > 0 ? UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(AssetPaths)) : nullptr;
+
+	// write the finished round's records off the game thread
+	SessionLog.FlushAsync();
+}
+
+void AShooterTrainingSession::ResetSpawnersForRound()
+{
+	const EShooterDrillType DrillType = GetRoundConfig()->GetRound(CurrentRound).DrillType;
+
+	for (ATargetSpawner* Spawner : Spawners)
+	{
+		if (!IsValid(Spawner))
+		{
+			continue;
+		}
+
+		if (Spawner->GetDrillType() == DrillType)
+		{
+			Spawner->ResetSpawner();
+
+		} else {
+
+			Spawner->WithdrawTarget();
+		}
+	}
+}
+
+void AShooterTrainingSession::OpenSessionLog()
+{
+	// include milliseconds so back to back sessions get their own files
+	TStringBuilder<128> SessionName;
+	SessionName.Appendf(TEXT("Session_%s"), *FDateTime::Now().ToString(TEXT("%Y.%m.%d-%H.%M.%S.%s")));
+
+	// concurrent sessions on the same host also need the session index
+	if (SessionIndex > 0)
+	{
+		SessionName.Appendf(TEXT("_%d"), SessionIndex);
+	}
+
+	SessionLog.Open(SessionName.ToString());
+}
+
+int32 AShooterTrainingSession::GetSpawnSeed(int32 SpawnerIndex) const
+{
+	// a seed from the round config gives every player the same targets
+	const int32 ConfigSeed = GetRoundConfig()->GetRound(CurrentRound).SpawnSeed;
+
+	if (ConfigSeed != 0)
+	{
+		return ConfigSeed;
+	}
+
+	// otherwise derive one from the session seed, so a replay can rebuild the schedule from a single number
+	const uint32 Hash = HashCombineFast(HashCombineFast(GetTypeHash(SessionSeed), GetTypeHash(CurrentRound)), GetTypeHash(SpawnerIndex));
+
+	// zero would make the spawner pick a random seed
+	return Hash != 0 ? static_cast<int32>(Hash) : 1;
+}
+
+void AShooterTrainingSession::BeginReplay()
+{
+	FShooterReplayHeader Header;
+	Header.SessionSeed = SessionSeed;
+
+	const UShooterRoundConfig* RoundConfig = GetRoundConfig();
+	Header.IntermissionDuration = RoundConfig->IntermissionDuration;
+
+	for (int32 Round = 1; Round <= RoundConfig->GetNumRounds(); ++Round)
+	{
+		FShooterReplayRound& ReplayRound = Header.Rounds.AddDefaulted_GetRef();
+		ReplayRound.Duration = RoundConfig->GetRound(Round).Duration;
+		ReplayRound.SpawnSeed = RoundConfig->GetRound(Round).SpawnSeed;
+	}
+
+	Replay.Begin(Header);
+	ReplayStartTime = GetWorld()->GetTimeSeconds();
+	ReplayWeaponPath.Reset();
+	LastReplayKeyframeTime = -1.0;
+
+	// keyframes pull the playback back in line if it drifts
+	GetWorld()->GetTimerManager().SetTimer(ReplayKeyframeTimer, this, &AShooterTrainingSession::WriteReplayKeyframe, ReplayKeyframeInterval, true);
+}
+
+void AShooterTrainingSession::SaveReplay()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ReplayKeyframeTimer);
+	}
+
+	// the replay is only written once, when the session finishes, resets or goes away
+	if (!Replay.IsRecording() || !SessionLog.GetFilename().Len())
+	{
+		return;
+	}
+
+	Replay.Save(FPaths::ChangeExtension(SessionLog.GetFilename(), TEXT("replay")));
+}
+
+double AShooterTrainingSession::GetReplayTime() const
+{
+	return GetWorld()->GetTimeSeconds() - ReplayStartTime;
+}
+
+void AShooterTrainingSession::WriteReplayKeyframe()
+{
+	// the player's view only matters while they can shoot
+	APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	if (!Replay.IsRecording() || !PlayerPawn || RoundState != EShooterRoundState::InRound)
+	{
+		return;
+	}
+
+	const double Time = GetReplayTime();
+
+	// weapons are picked up in the level, so record which one is in hand
+	if (const AShooterCharacter* PlayerCharacter = Cast<AShooterCharacter>(PlayerPawn))
+	{
+		const AShooterWeapon* Weapon = PlayerCharacter->GetCurrentWeapon();
+		const FString WeaponPath = Weapon ? Weapon->GetClass()->GetPathName() : FString();
+
+		if (WeaponPath != ReplayWeaponPath)
+		{
+			ReplayWeaponPath = WeaponPath;
+			Replay.WriteWeapon(Time, WeaponPath);
+		}
+	}
+
+	Replay.WriteKeyframe(Time, PlayerPawn->GetActorLocation(), PlayerController->GetControlRotation());
+	LastReplayKeyframeTime = Time;
+}
+
+void AShooterTrainingSession::WriteShotKeyframe()
+{
+	// refire timers don't line up with the playback's frames, so the periodic and trigger press keyframes
+	// alone leave the later shots of a burst aimed wherever the replayed input got to. The press already wrote one
+	if (Replay.IsRecording() && GetReplayTime() != LastReplayKeyframeTime)
+	{
+		WriteReplayKeyframe();
+	}
+}
+
+void AShooterTrainingSession::RecordAimInput(float Yaw, float Pitch)
+{
+	if (Replay.IsRecording())
+	{
+		Replay.WriteAim(GetReplayTime(), Yaw, Pitch);
+	}
+}
+
+void AShooterTrainingSession::RecordFireInput(bool bPressed)
+{
+	if (!Replay.IsRecording())
+	{
+		return;
+	}
+
+	// pin down the exact view for every trigger press, so each shot replays the same even if the aim drifted
+	if (bPressed)
+	{
+		WriteReplayKeyframe();
+	}
+
+	Replay.WriteFire(GetReplayTime(), bPressed);
+}
+
+void AShooterTrainingSession::ResetSession()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// stop the round clock and wrap up the old log and replay
+	StopStateTimer();
+	SaveReplay();
+	SessionLog.Close();
+
+	// reset the counters
+	CurrentRound = 1;
+	SuccessfulHits = 0;
+	MissedShots = 0;
+	Accuracy = 0.f;
+	AvgReactionTime = 0.f;
+	AvgReactionTimeCorrected = 0.f;
+	LastShotTime = -1.0f;
+	RoundStartHits = 0;
+	RoundStartMisses = 0;
+	CurrentTarget.Reset();
+	PendingSpawns.Reset();
+	NumSpawnedTargets = 0;
+
+	// empty the per target arrays, keeping their allocations
+	TargetSpawnTimes.Reset();
+	TargetShotTimes.Reset();
+	TargetSpawnTimings.Reset();
+	TargetShotTimings.Reset();
+	AimSegmentSamples.Reset();
+
+	// clear the distributions
+	RoundReactionTimes.Reset();
+	RoundCorrectedReactionTimes.Reset();
+	RoundShotIntervals.Reset();
+	SessionReactionTimes.Reset();
+	SessionCorrectedReactionTimes.Reset();
+	SessionShotIntervals.Reset();
+
+	// start a new telemetry log and replay with a fresh seed so sessions don't mix
+	OpenSessionLog();
+	SessionSeed = FMath::Rand();
+	BeginReplay();
+
+	ResetPlayer();
+
+	// bring up fresh targets for the first round. This logs the first spawns into the new session
+	ResetSpawnersForRound();
+
+	LogResetTime(TEXT("InPlace"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	// wait for the first round again
+	SetRoundState(EShooterRoundState::WaitingToStart);
+}
+
+void AShooterTrainingSession::ResetPlayer()
+{
+	AShooterGameMode* GameMode = GetShooterGameMode();
+
+	if (!PlayerController || !GameMode)
+	{
+		return;
+	}
+
+	AShooterCharacter* PlayerCharacter = Cast<AShooterCharacter>(PlayerController->GetPawn());
+
+	// a dead or missing character goes through the regular respawn
+	if (!PlayerCharacter || !PlayerCharacter->ResetForNewSession())
+	{
+		if (PlayerCharacter)
+		{
+			PlayerCharacter->Destroy();
+		}
+
+		GameMode->RestartPlayer(PlayerController);
+		return;
+	}
+
+	// move the character back to the start
+	if (AActor* StartSpot = GameMode->FindPlayerStart(PlayerController))
+	{
+		PlayerCharacter->TeleportTo(StartSpot->GetActorLocation(), StartSpot->GetActorRotation());
+		PlayerController->SetControlRotation(StartSpot->GetActorRotation());
+	}
+}
+
+void AShooterTrainingSession::LogResetTime(const TCHAR* ResetType, double Milliseconds)
+{
+	UE_LOG(LogTemp, Display, TEXT("Session reset (%s) took %.3f ms"), ResetType, Milliseconds);
+
+	// Reset,Type,Milliseconds
+	TStringBuilder<64> Line;
+	Line.Appendf(TEXT("Reset,%s,%.3f"), ResetType, Milliseconds);
+	SessionLog.WriteLine(Line);
+}
+
+void AShooterTrainingSession::StartRound()
+{
+	// rounds can only be started from between rounds
+	if (RoundState == EShooterRoundState::WaitingToStart || RoundState == EShooterRoundState::Intermission)
+	{
+		SetRoundState(EShooterRoundState::InRound);
+	}
+}
+
+void AShooterTrainingSession::SetRoundState(EShooterRoundState NewState)
+{
+	RoundState = NewState;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterTrainingSession, RoundState, this);
+
+	switch (NewState)
+	{
+	case EShooterRoundState::WaitingToStart:
+
+		// get the next round ready while we wait
+		PrepareNextRound();
+
+		// skip the start button if rounds start on their own
+		if (bAutoStartRounds)
+		{
+			SetRoundState(EShooterRoundState::InRound);
+			return;
+		}
+
+		StopStateTimer();
+		DisablePlayerInput();
+
+		if (ShooterUI)
+		{
+			ShooterUI->BP_ShowStartRoundButton();
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Waiting for player to start Round %d"), CurrentRound);
+		break;
+
+	case EShooterRoundState::InRound:
+
+		// reset the per round stats
+		LastShotTime = -1.0f;
+		RoundStartHits = SuccessfulHits;
+		RoundStartMisses = MissedShots;
+
+		EnablePlayerInput();
+
+		// bring up the round's first targets so reaction times start with the round
+		ResetSpawnersForRound();
+
+		if (ShooterUI)
+		{
+			ShooterUI->BP_HideStartRoundButton();
+		}
+
+		StartStateTimer(GetRoundConfig()->GetRound(CurrentRound).Duration);
+
+		if (Replay.IsRecording())
+		{
+			Replay.WriteRoundStarted(GetReplayTime(), CurrentRound);
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("Round %d started!"), CurrentRound);
+		SHOOTER_TRACE(RoundStarted, CurrentRound);
+		break;
+
+	case EShooterRoundState::Intermission:
+
+		// the world keeps running, so use the break to get the next round ready
+		DisablePlayerInput();
+		PrepareNextRound();
+
+		// the player can still skip the intermission
+		if (ShooterUI)
+		{
+			ShooterUI->BP_ShowStartRoundButton();
+		}
+
+		StartStateTimer(GetRoundConfig()->IntermissionDuration);
+
+		UE_LOG(LogTemp, Display, TEXT("Intermission before Round %d"), CurrentRound);
+		break;
+
+	case EShooterRoundState::Finished:
+
+		StopStateTimer();
+		DisablePlayerInput();
+
+		// Calculate and log accuracy
+		CalculateAccuracy();
+
+		// Calculate and log average spawn time
+		CalculateAverageSpawnTime();
+
+		// Export the session summary with the reaction time and shot interval quantiles
+		ExportSessionSummary();
+
+		// close the replay with the final score, so playback can be checked against it
+		if (Replay.IsRecording())
+		{
+			Replay.WriteEnd(GetReplayTime(), SuccessfulHits, MissedShots);
+			SaveReplay();
+		}
+
+		OnShooterSessionFinished.Broadcast();
+		break;
+	}
+}
+
+const UShooterRoundConfig* AShooterTrainingSession::GetRoundConfig() const
+{
+	// every session on the host plays the same rounds
+	const AShooterGameMode* GameMode = GetShooterGameMode();
+	return GameMode ? GameMode->GetRoundConfig() : GetDefault<UShooterRoundConfig>();
+}
+
+void AShooterTrainingSession::SetAutoStartRounds(bool bAutoStart)
+{
+	bAutoStartRounds = bAutoStart;
+
+	// don't leave a round waiting for a button nobody will press
+	if (bAutoStartRounds && RoundState == EShooterRoundState::WaitingToStart && HasActorBegunPlay())
+	{
+		SetRoundState(EShooterRoundState::InRound);
+	}
+}
+
+void AShooterTrainingSession::StartStateTimer(float Duration)
+{
+	GetWorld()->GetTimerManager().SetTimer(StateTimer, this, &AShooterTrainingSession::OnStateTimerExpired, Duration, false);
+
+	// force a UI refresh for the new state
+	DisplayedSeconds = -1;
+	UpdateTimerDisplay();
+}
+
+void AShooterTrainingSession::StopStateTimer()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(StateTimer);
+		World->GetTimerManager().ClearTimer(DisplayTimer);
+	}
+
+	// make sure the UI doesn't keep showing a stale countdown
+	if (DisplayedSeconds > 0 && ShooterUI)
+	{
+		ShooterUI->BP_UpdateTimer(0.0f);
+	}
+
+	DisplayedSeconds = 0;
+}
+
+float AShooterTrainingSession::GetStateTimeRemaining() const
+{
+	return FMath::Max(0.0f, GetWorld()->GetTimerManager().GetTimerRemaining(StateTimer));
+}
+
+void AShooterTrainingSession::OnStateTimerExpired()
+{
+	switch (RoundState)
+	{
+	case EShooterRoundState::InRound:
+		EndRound();
+		break;
+
+	case EShooterRoundState::Intermission:
+		SetRoundState(EShooterRoundState::InRound);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void AShooterTrainingSession::UpdateTimerDisplay()
+{
+	const float Remaining = GetStateTimeRemaining();
+	const int32 Seconds = FMath::CeilToInt(Remaining);
+
+	// only update the UI when the displayed second changes
+	if (Seconds != DisplayedSeconds)
+	{
+		DisplayedSeconds = Seconds;
+
+		if (ShooterUI)
+		{
+			ShooterUI->BP_UpdateTimer(static_cast<float>(Seconds));
+		}
+	}
+
+	// schedule the next update for when the displayed second drops. Sessions without a UI don't need it
+	if (Remaining > 0.0f && ShooterUI)
+	{
+		const float TimeToNextSecond = Remaining - static_cast<float>(Seconds - 1);
+		GetWorld()->GetTimerManager().SetTimer(DisplayTimer, this, &AShooterTrainingSession::UpdateTimerDisplay, FMath::Max(TimeToNextSecond, KINDA_SMALL_NUMBER), false);
+	}
+}
+
+void AShooterTrainingSession::EndRound()
+{
+	UE_LOG(LogTemp, Display, TEXT("Round %d ended!"), CurrentRound);
+	SHOOTER_TRACE(RoundEnded, CurrentRound);
+
+	// export the round distributions before moving on
+	ExportRoundSummary();
+
+	OnShooterRoundEnded.Broadcast(CurrentRound);
+
+	if (CurrentRound < GetRoundConfig()->GetNumRounds())
+	{
+		++CurrentRound;
+
+		// either count down to the next round or wait for the player
+		SetRoundState(GetRoundConfig()->IntermissionDuration > 0.0f ? EShooterRoundState::Intermission : EShooterRoundState::WaitingToStart);
+	}
+	else
+	{
+		SetRoundState(EShooterRoundState::Finished);
+	}
+}
+
+void AShooterTrainingSession::CalculateAccuracy()
+{
+	int32 TotalShots = SuccessfulHits + MissedShots;
+	if (TotalShots > 0)
+	{
+		Accuracy = (static_cast<float>(SuccessfulHits) / static_cast<float>(TotalShots)) * 100.f;
+	}
+	else
+	{
+		Accuracy = 0.f;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Successful shots: %d"), SuccessfulHits);
+	UE_LOG(LogTemp, Display, TEXT("Missed shots: %d"), MissedShots);
+	UE_LOG(LogTemp, Display, TEXT("Total shots: %d"), SuccessfulHits + MissedShots);
+	UE_LOG(LogTemp, Display, TEXT("Player Accuracy: %.2f%%"), Accuracy);
+}
+
+void AShooterTrainingSession::CalculateAverageSpawnTime()
+{
+	if (TargetSpawnTimes.Num() > 0 && TargetShotTimes.Num() > 0)
+	{
+		float TotalTime = 0.f;
+		float TotalCorrectedTime = 0.f;
+
+		for (int32 i = 0; i < TargetShotTimes.Num(); ++i)
+		{
+			const float ReactionTime = TargetShotTimes[i] - TargetSpawnTimes[i];
+			TotalTime += ReactionTime;
+			TotalCorrectedTime += FShooterFrameTiming::CorrectReactionTime(ReactionTime, TargetSpawnTimings[i], TargetShotTimings[i]);
+		}
+
+		AvgReactionTime = TotalTime / static_cast<float>(TargetShotTimes.Num());
+		AvgReactionTimeCorrected = TotalCorrectedTime / static_cast<float>(TargetShotTimes.Num());
+		UE_LOG(LogTemp, Display, TEXT("Total spawn time: %.2f"), TotalTime);
+		UE_LOG(LogTemp, Display, TEXT("Average Reaction Time: %.2f seconds"), AvgReactionTime);
+		UE_LOG(LogTemp, Display, TEXT("Average Reaction Time (latency corrected): %.2f seconds"), AvgReactionTimeCorrected);
+		UE_LOG(LogTemp, Display, TEXT("Reaction Time p50: %.3f p90: %.3f p95: %.3f p99: %.3f seconds"),
+			SessionReactionTimes.GetQuantile(0.5), SessionReactionTimes.GetQuantile(0.9), SessionReactionTimes.GetQuantile(0.95), SessionReactionTimes.GetQuantile(0.99));
+	}
+	else
+	{
+		AvgReactionTime = 0.f;
+		AvgReactionTimeCorrected = 0.f;
+		UE_LOG(LogTemp, Display, TEXT("No targets were spawned or shot."));
+	}
+}
+
+void AShooterTrainingSession::AppendQuantiles(FStringBuilderBase& Line, const FShooterQuantileSketch& Sketch)
+{
+	Line.Appendf(TEXT(",%.4f,%.4f,%.4f,%.4f,%.4f"), Sketch.GetQuantile(0.5), Sketch.GetQuantile(0.9), Sketch.GetQuantile(0.95), Sketch.GetQuantile(0.99), Sketch.GetMax());
+}
+
+void AShooterTrainingSession::AppendFrameTiming(FStringBuilderBase& Line, const FShooterFrameTiming& Timing)
+{
+	Line.Appendf(TEXT(",%.5f,%.5f,%.5f,%.5f,%.5f"), Timing.DeltaTime, Timing.GameThreadTime, Timing.RenderThreadTime, Timing.GPUTime, Timing.InputLatency);
+}
+
+void AShooterTrainingSession::WriteShotRecord(int32 TargetIndex, bool bHit, const FShooterFrameTiming& Timing)
+{
+	// Shot,Round,TargetIndex,Time,Hit,DeltaTime,GameThread,RenderThread,GPU,InputLatency
+	TStringBuilder<256> Line;
+	Line.Appendf(TEXT("Shot,%d,%d,%.4f,%d"), CurrentRound, TargetIndex, GetWorld()->GetTimeSeconds(), bHit ? 1 : 0);
+	AppendFrameTiming(Line, Timing);
+	SessionLog.WriteLine(Line);
+}
+
+void AShooterTrainingSession::ExportRoundSummary()
+{
+	// RoundSummary,Round,Hits,Misses,AvgReactionTime,AvgReactionTimeCorrected,RT p50/p90/p95/p99/max,ShotInterval p50/p90/p95/p99/max
+	TStringBuilder<256> Line;
+	Line.Appendf(TEXT("RoundSummary,%d,%d,%d,%.4f,%.4f"), CurrentRound, SuccessfulHits - RoundStartHits, MissedShots - RoundStartMisses, RoundReactionTimes.GetMean(), RoundCorrectedReactionTimes.GetMean());
+	AppendQuantiles(Line, RoundReactionTimes);
+	AppendQuantiles(Line, RoundShotIntervals);
+	SessionLog.WriteLine(Line);
+
+	// fold the round into the session and start fresh
+	SessionReactionTimes.Merge(RoundReactionTimes);
+	SessionCorrectedReactionTimes.Merge(RoundCorrectedReactionTimes);
+	SessionShotIntervals.Merge(RoundShotIntervals);
+
+	RoundReactionTimes.Reset();
+	RoundCorrectedReactionTimes.Reset();
+	RoundShotIntervals.Reset();
+}
+
+void AShooterTrainingSession::ExportSessionSummary()
+{
+	// SessionSummary,Hits,Misses,Accuracy,AvgReactionTime,AvgReactionTimeCorrected,RT p50/p90/p95/p99/max,ShotInterval p50/p90/p95/p99/max
+	TStringBuilder<256> Line;
+	Line.Appendf(TEXT("SessionSummary,%d,%d,%.2f,%.4f,%.4f"), SuccessfulHits, MissedShots, Accuracy, AvgReactionTime, AvgReactionTimeCorrected);
+	AppendQuantiles(Line, SessionReactionTimes);
+	AppendQuantiles(Line, SessionShotIntervals);
+	SessionLog.WriteLine(Line);
+	SessionLog.Flush();
+}
+
+void AShooterTrainingSession::OnTargetSpawned(AActor* Target)
+{
+	// keep the spawn until we know whether this target gets hit or withdrawn
+	FShooterPendingSpawn& Spawn = PendingSpawns.Add(Target);
+	Spawn.TargetIndex = NumSpawnedTargets++;
+	Spawn.Time = GetWorld()->GetTimeSeconds();
+	Spawn.Timing = FShooterFrameTiming::Capture();
+
+	const FVector Location = Target->GetActorLocation();
+	SHOOTER_TRACE(TargetSpawned, Spawn.TargetIndex, Location);
+
+	// Spawn,Round,TargetIndex,Time,X,Y,Z,DeltaTime,GameThread,RenderThread,GPU,InputLatency
+	TStringBuilder<256> Line;
+	Line.Appendf(TEXT("Spawn,%d,%d,%.4f,%.1f,%.1f,%.1f"), CurrentRound, Spawn.TargetIndex, Spawn.Time, Location.X, Location.Y, Location.Z);
+	AppendFrameTiming(Line, Spawn.Timing);
+	SessionLog.WriteLine(Line);
+
+	PushSpawnEvent(Location);
+
+	// start a new aim trajectory segment for the player
+	if (AShooterCharacter* PlayerCharacter = PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr)
+	{
+		PlayerCharacter->GetAimHistory().BeginSegment(FPlatformTime::Cycles64());
+	}
+
+	CurrentTarget = Target;
+	OnShooterTargetSpawned.Broadcast(Target);
+}
+
+void AShooterTrainingSession::OnTargetWithdrawn(AActor* Target)
+{
+	// forget the spawn of this target only, other targets may still be waiting to be hit
+	FShooterPendingSpawn Spawn;
+
+	if (PendingSpawns.RemoveAndCopyValue(Target, Spawn))
+	{
+		// Withdrawn,Round,TargetIndex,Time
+		TStringBuilder<64> Line;
+		Line.Appendf(TEXT("Withdrawn,%d,%d,%.4f"), CurrentRound, Spawn.TargetIndex, GetWorld()->GetTimeSeconds());
+		SessionLog.WriteLine(Line);
+	}
+
+	if (CurrentTarget == Target)
+	{
+		CurrentTarget.Reset();
+	}
+}
+
+bool AShooterTrainingSession::IsSessionPawn(const APawn* Pawn) const
+{
+	return Pawn && PlayerController && PlayerController->GetPawn() == Pawn;
+}
+
+void AShooterTrainingSession::OnTargetHit(const APawn* Shooter, AActor* Target, const FVector& ImpactPoint)
+{
+	// anyone else's shots would skew the score and break the replay check
+	if (!IsSessionPawn(Shooter))
+	{
+		return;
+	}
+
+	WriteShotKeyframe();
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const FShooterFrameTiming Timing = FShooterFrameTiming::Capture();
+	SuccessfulHits++;
+
+	if (CurrentTarget == Target)
+	{
+		CurrentTarget.Reset();
+	}
+
+	RecordShotInterval();
+
+	// pair the hit with this target's own spawn. Targets we never saw spawn count as spawned on the hit
+	FShooterPendingSpawn Spawn;
+
+	if (!PendingSpawns.RemoveAndCopyValue(Target, Spawn))
+	{
+		Spawn.Time = Now;
+		Spawn.Timing = Timing;
+	}
+
+	// the per target arrays stay paired by index for the reaction time average
+	TargetSpawnTimes.Add(Spawn.Time);
+	TargetSpawnTimings.Add(Spawn.Timing);
+	TargetShotTimes.Add(Now);
+	TargetShotTimings.Add(Timing);
+
+	const int32 TargetIndex = Spawn.TargetIndex;
+	const float ReactionTime = Now - Spawn.Time;
+
+	RoundReactionTimes.Record(ReactionTime);
+	RoundCorrectedReactionTimes.Record(FShooterFrameTiming::CorrectReactionTime(ReactionTime, Spawn.Timing, Timing));
+	SHOOTER_TRACE(TargetHit, TargetIndex, ReactionTime);
+
+	WriteShotRecord(TargetIndex, true, Timing);
+	PushShotEvent(ImpactPoint, true);
+
+	// log the trajectory that led to this hit
+	FlushAimSegment(TargetIndex, ReactionTime);
+}
+
+void AShooterTrainingSession::OnShotMissed(const APawn* Shooter, const FVector& ImpactPoint)
+{
+	if (!IsSessionPawn(Shooter))
+	{
+		return;
+	}
+
+	WriteShotKeyframe();
+
+	MissedShots++;
+
+	// attribute the miss to the target the player was most likely aiming for
+	const FShooterPendingSpawn* Spawn = PendingSpawns.Find(CurrentTarget.Get());
+	const int32 TargetIndex = Spawn ? Spawn->TargetIndex : INDEX_NONE;
+
+	SHOOTER_TRACE(ShotMissed, TargetIndex);
+
+	WriteShotRecord(TargetIndex, false, FShooterFrameTiming::Capture());
+	PushShotEvent(ImpactPoint, false);
+
+	RecordShotInterval();
+}
+
+void AShooterTrainingSession::RecordShotInterval()
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	if (LastShotTime >= 0.0f)
+	{
+		RoundShotIntervals.Record(Now - LastShotTime);
+	}
+
+	LastShotTime = Now;
+}
+
+void AShooterTrainingSession::FlushAimSegment(int32 TargetIndex, float ReactionTime)
+{
+	AShooterCharacter* PlayerCharacter = PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr;
+	if (!PlayerCharacter || !SessionLog.IsOpen())
+	{
+		return;
+	}
+
+	const FShooterAimHistory& AimHistory = PlayerCharacter->GetAimHistory();
+	AimHistory.Decode(AimSegmentSamples);
+
+	// Trajectory,Round,TargetIndex,ReactionTime,NumSamples,NumDropped,TimeMs:Yaw:Pitch;...
+	TStringBuilder<4096> Line;
+	Line.Appendf(TEXT("Trajectory,%d,%d,%.4f,%d,%d,"), CurrentRound, TargetIndex, ReactionTime, AimSegmentSamples.Num(), AimHistory.GetNumDropped());
+
+	for (const FShooterAimSample& Sample : AimSegmentSamples)
+	{
+		Line.Appendf(TEXT("%.2f:%.3f:%.3f;"), Sample.Time * 1000.0, Sample.Yaw, Sample.Pitch);
+	}
+
+	SessionLog.WriteLine(Line);
+}
+
+void AShooterTrainingSession::PushShotEvent(const FVector& ImpactPoint, bool bHit)
+{
+	// nobody to replicate to
+	if (GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const int32 Slot = ShotSequence % ShooterEventRingSize;
+
+	FShooterShotEvent& Event = ShotRing[Slot];
+	Event.ImpactPoint = ImpactPoint;
+	Event.SetAim(PlayerController ? PlayerController->GetControlRotation() : FRotator::ZeroRotator);
+	Event.DeltaMs = FShooterEventTime::ToDeltaMs(Now - LastShotEventTime);
+	Event.bHit = bHit;
+
+	// advance by what the client will add up, so the rounding doesn't drift over a long session
+	LastShotEventTime += FShooterEventTime::FromDeltaMs(Event.DeltaMs);
+	++ShotSequence;
+
+	// only the changed slot and the sequence go out on the next update
+	MARK_PROPERTY_DIRTY_FROM_NAME_STATIC_ARRAY_INDEX(AShooterTrainingSession, ShotRing, Slot, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterTrainingSession, ShotSequence, this);
+}
+
+void AShooterTrainingSession::PushSpawnEvent(const FVector& Location)
+{
+	// nobody to replicate to
+	if (GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const int32 Slot = SpawnSequence % ShooterEventRingSize;
+
+	FShooterSpawnEvent& Event = SpawnRing[Slot];
+	Event.Location = Location;
+	Event.DeltaMs = FShooterEventTime::ToDeltaMs(Now - LastSpawnEventTime);
+
+	LastSpawnEventTime += FShooterEventTime::FromDeltaMs(Event.DeltaMs);
+	++SpawnSequence;
+
+	MARK_PROPERTY_DIRTY_FROM_NAME_STATIC_ARRAY_INDEX(AShooterTrainingSession, SpawnRing, Slot, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AShooterTrainingSession, SpawnSequence, this);
+}
+
+double AShooterTrainingSession::GetServerTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+/** Broadcasts the ring events after LastReceived in order, rebuilding their server times from the deltas */
+template<typename EventType, typename DelegateType>
+static void ReceiveEventRing(const EventType (&Ring)[ShooterEventRingSize], int32 Sequence, int32& LastReceived, double& LastTime, double StreamStartTime, double ServerTime, const DelegateType& Delegate)
+{
+	int32 First = LastReceived;
+
+	if (LastTime < 0.0)
+	{
+		LastTime = StreamStartTime;
+	}
+
+	// events that dropped out of the ring before we saw them are lost, so time the rest back from now
+	if (Sequence - First > ShooterEventRingSize)
+	{
+		First = Sequence - ShooterEventRingSize;
+		LastTime = ServerTime;
+
+		for (int32 i = First; i < Sequence; ++i)
+		{
+			LastTime -= FShooterEventTime::FromDeltaMs(Ring[i % ShooterEventRingSize].DeltaMs);
+		}
+	}
+
+	for (int32 i = First; i < Sequence; ++i)
+	{
+		const EventType& Event = Ring[i % ShooterEventRingSize];
+		LastTime += FShooterEventTime::FromDeltaMs(Event.DeltaMs);
+		Delegate.Broadcast(Event, LastTime);
+	}
+
+	LastReceived = Sequence;
+}
+
+void AShooterTrainingSession::OnRep_RoundState()
+{
+	PresentRoundState();
+}
+
+void AShooterTrainingSession::PresentRoundState()
+{
+	// the same cursor and start button changes the server makes as it enters each state
+	if (RoundState == EShooterRoundState::InRound)
+	{
+		EnablePlayerInput();
+
+		if (ShooterUI)
+		{
+			ShooterUI->BP_HideStartRoundButton();
+		}
+
+		return;
+	}
+
+	DisablePlayerInput();
+
+	if (ShooterUI && RoundState != EShooterRoundState::Finished)
+	{
+		ShooterUI->BP_ShowStartRoundButton();
+	}
+}
+
+void AShooterTrainingSession::OnRep_ShotSequence()
+{
+	ReceiveEventRing(ShotRing, ShotSequence, ReceivedShotSequence, ReceivedShotTime, EventStreamStartTime, GetServerTime(), OnShotReplicated);
+}
+
+void AShooterTrainingSession::OnRep_SpawnSequence()
+{
+	ReceiveEventRing(SpawnRing, SpawnSequence, ReceivedSpawnSequence, ReceivedSpawnTime, EventStreamStartTime, GetServerTime(), OnSpawnReplicated);
+}
+
+// Enable player input. Fire and look input follow the round state through IsCombatInputAllowed
+void AShooterTrainingSession::EnablePlayerInput()
+{
+	if (PlayerController)
+	{
+		PlayerController->bShowMouseCursor = false;
+	}
+}
+
+// Disable player input. The world isn't paused so timers and background work keep running
+void AShooterTrainingSession::DisablePlayerInput()
+{
+	if (PlayerController)
+	{
+		PlayerController->bShowMouseCursor = true;
+	}
+}
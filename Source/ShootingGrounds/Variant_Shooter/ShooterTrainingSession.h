@@ -0,0 +1,425 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "ShooterAimHistory.h"
+#include "ShooterFrameTiming.h"
+#include "ShooterQuantileSketch.h"
+#include "ShooterSessionLog.h"
+#include "ShooterSessionEvents.h"
+#include "ShooterReplay.h"
+#include "Engine/StreamableManager.h"
+#include "ShooterTrainingSession.generated.h"
+
+class AShooterGameMode;
+class APawn;
+class ATargetSpawner;
+class UShooterUI;
+class UShooterRoundConfig;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FShooterTargetSpawnedDelegate, AActor* /* Target */);
+DECLARE_MULTICAST_DELEGATE_OneParam(FShooterRoundEndedDelegate, int32 /* Round */);
+DECLARE_MULTICAST_DELEGATE(FShooterSessionFinishedDelegate);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FShooterShotReplicatedDelegate, const FShooterShotEvent& /* Shot */, double /* ServerTime */);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FShooterSpawnReplicatedDelegate, const FShooterSpawnEvent& /* Spawn */, double /* ServerTime */);
+
+/**
+ *  A spawned target that hasn't been hit or withdrawn yet
+ */
+struct FShooterPendingSpawn
+{
+	/** Index of the spawn in the session's spawn order */
+	int32 TargetIndex = INDEX_NONE;
+
+	/** Game time the target was spawned */
+	float Time = 0.0f;
+
+	/** Frame timing captured when the target was spawned */
+	FShooterFrameTiming Timing;
+};
+
+/**
+ *  States of the round flow
+ */
+UENUM(BlueprintType)
+enum class EShooterRoundState : uint8
+{
+	/** Waiting for the player to start the next round */
+	WaitingToStart,
+
+	/** A round is being played */
+	InRound,
+
+	/** Timed break between rounds. The next round starts on its own */
+	Intermission,
+
+	/** All rounds have been played */
+	Finished
+};
+
+/**
+ *  A single player's aim training session
+ *  Runs the round flow, keeps the shot and reaction time stats and writes the telemetry log for one player
+ *  Spawned by the shooter game mode for every player that joins. When the game mode hosts multiple sessions,
+ *  each session gets its own instances of the level's target spawners, so players never share targets
+ *  The round flow runs on the server. The round state, shots and spawns are replicated to the owning player only,
+ *  the events as compact entries in small rings of push model properties, so each update only carries the new entries.
+ *  Remote players start rounds and shoot through server RPCs on their controller and character
+ *  Every session also records a replay of its seeds and the player's input next to its telemetry log
+ */
+UCLASS()
+class SHOOTINGGROUNDS_API AShooterTrainingSession : public AInfo
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Player training in this session */
+	UPROPERTY(Transient)
+	TObjectPtr<APlayerController> PlayerController;
+
+	/** Target spawners feeding this session */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ATargetSpawner>> Spawners;
+
+	/** Pointer to the UI widget. Only set for local players */
+	UPROPERTY(Transient)
+	TObjectPtr<UShooterUI> ShooterUI;
+
+	/** Index of this session on the host. Keeps the log files of concurrent sessions apart */
+	int32 SessionIndex = 0;
+
+	/** If true, rounds start on their own instead of waiting for the start button */
+	bool bAutoStartRounds = false;
+
+	/** Current state of the round flow. Replicated to the owning player, who gates their input on it */
+	UPROPERTY(ReplicatedUsing=OnRep_RoundState)
+	EShooterRoundState RoundState = EShooterRoundState::WaitingToStart;
+
+	/** Fires when the current timed state ends. This is the only round clock */
+	FTimerHandle StateTimer;
+
+	/** Fires when the displayed number of seconds left changes */
+	FTimerHandle DisplayTimer;
+
+	/** Number of seconds last sent to the UI */
+	int32 DisplayedSeconds = -1;
+
+	/** Telemetry log for this session */
+	FShooterSessionLog SessionLog;
+
+	/** Scratch array for decoding aim segments */
+	TArray<FShooterAimSample> AimSegmentSamples;
+
+	/** Reaction time distribution for the current round */
+	FShooterQuantileSketch RoundReactionTimes;
+
+	/** Time between consecutive shots for the current round */
+	FShooterQuantileSketch RoundShotIntervals;
+
+	/** Frame latency corrected reaction time distribution for the current round */
+	FShooterQuantileSketch RoundCorrectedReactionTimes;
+
+	/** Reaction time distribution for the whole session. Rounds are merged into it as they end */
+	FShooterQuantileSketch SessionReactionTimes;
+
+	/** Frame latency corrected reaction time distribution for the whole session */
+	FShooterQuantileSketch SessionCorrectedReactionTimes;
+
+	/** Time between consecutive shots for the whole session. Rounds are merged into it as they end */
+	FShooterQuantileSketch SessionShotIntervals;
+
+	/** Game time of the last shot fired this round, or negative if none */
+	float LastShotTime = -1.0f;
+
+	/** Hit and miss counters at the start of the current round */
+	int32 RoundStartHits = 0;
+	int32 RoundStartMisses = 0;
+
+	/** Most recently spawned target that hasn't been hit yet */
+	TWeakObjectPtr<AActor> CurrentTarget;
+
+	/** Spawns of the targets that haven't been hit or withdrawn yet, by target */
+	TMap<TObjectKey<AActor>, FShooterPendingSpawn> PendingSpawns;
+
+	/** Number of targets spawned this session */
+	int32 NumSpawnedTargets = 0;
+
+	/** Seed the spawn schedules are derived from, for rounds that don't set their own */
+	int32 SessionSeed = 0;
+
+	/** Replay recording of this session */
+	FShooterReplayWriter Replay;
+
+	/** World time the replay is timed from */
+	double ReplayStartTime = 0.0;
+
+	/** Time between replay keyframes during a round */
+	float ReplayKeyframeInterval = 1.0f;
+
+	/** Writes replay keyframes while a round is in progress */
+	FTimerHandle ReplayKeyframeTimer;
+
+	/** Weapon class last written to the replay */
+	FString ReplayWeaponPath;
+
+	/** Replay time of the last keyframe written, or negative if none */
+	double LastReplayKeyframeTime = -1.0;
+
+	/** Keeps the assets streamed in for the upcoming round resident */
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	/** Server time the event streams are timed from */
+	UPROPERTY(Replicated)
+	float EventStreamStartTime = 0.0f;
+
+	/** Most recent shots. The next shot goes into the slot at ShotSequence modulo the ring size */
+	UPROPERTY(Replicated)
+	FShooterShotEvent ShotRing[ShooterEventRingSize];
+
+	/** Number of shots recorded since the session started */
+	UPROPERTY(ReplicatedUsing=OnRep_ShotSequence)
+	int32 ShotSequence = 0;
+
+	/** Most recent target spawns, in the same layout as the shot ring */
+	UPROPERTY(Replicated)
+	FShooterSpawnEvent SpawnRing[ShooterEventRingSize];
+
+	/** Number of spawns recorded since the session started */
+	UPROPERTY(ReplicatedUsing=OnRep_SpawnSequence)
+	int32 SpawnSequence = 0;
+
+	/** Server time of the last shot and spawn events, for the time deltas */
+	double LastShotEventTime = 0.0;
+	double LastSpawnEventTime = 0.0;
+
+	/** Client side: events already broadcast, and the reconstructed time of the last one */
+	int32 ReceivedShotSequence = 0;
+	int32 ReceivedSpawnSequence = 0;
+	double ReceivedShotTime = -1.0;
+	double ReceivedSpawnTime = -1.0;
+
+	int32 CurrentRound = 1;
+
+public:
+
+	AShooterTrainingSession();
+
+	/** Binds the session to its player and opens its telemetry log. Called by the game mode before the session begins play */
+	void InitSession(APlayerController* InPlayerController, int32 InSessionIndex, bool bInAutoStartRounds);
+
+protected:
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Returns the shooter game mode hosting this session */
+	AShooterGameMode* GetShooterGameMode() const;
+
+	/** Collects the level's target spawners, or spawns private instances of them if the host runs multiple sessions */
+	void CreateSpawners();
+
+	/** Moves the round flow to a new state and runs its entry logic */
+	void SetRoundState(EShooterRoundState NewState);
+
+	/** Starts the round clock for a timed state */
+	void StartStateTimer(float Duration);
+
+	/** Stops the round clock */
+	void StopStateTimer();
+
+	/** Called by the round clock when the current timed state runs out */
+	void OnStateTimerExpired();
+
+	/** Sends the seconds left to the UI and schedules the next update for when the displayed second changes */
+	void UpdateTimerDisplay();
+
+	/** Wraps up the current round and moves on to the next state */
+	void EndRound();
+
+	void CalculateAccuracy();
+
+	void CalculateAverageSpawnTime();
+
+	void EnablePlayerInput();
+
+	void DisablePlayerInput();
+
+	/** Writes the player's aim trajectory since the last target spawn to the session log */
+	void FlushAimSegment(int32 TargetIndex, float ReactionTime);
+
+	/** Records the interval since the previous shot */
+	void RecordShotInterval();
+
+	/** Exports the current round's distributions and merges them into the session */
+	void ExportRoundSummary();
+
+	/** Exports the session accuracy, average reaction time and distributions */
+	void ExportSessionSummary();
+
+	/** Appends frame timing metadata to a log line */
+	static void AppendFrameTiming(FStringBuilderBase& Line, const FShooterFrameTiming& Timing);
+
+	/** Writes a shot record with its frame timing to the session log */
+	void WriteShotRecord(int32 TargetIndex, bool bHit, const FShooterFrameTiming& Timing);
+
+	/** Uses the break before a round to fill target pools, build spawn schedules, stream assets and flush telemetry */
+	void PrepareNextRound();
+
+	/** Opens a new telemetry log for the session */
+	void OpenSessionLog();
+
+	/** Brings up fresh targets on the spawners serving the current round's drill, and withdraws the others' */
+	void ResetSpawnersForRound();
+
+	/** Returns the spawn schedule seed for one of our spawners in the upcoming round */
+	int32 GetSpawnSeed(int32 SpawnerIndex) const;
+
+	/** Starts a new replay recording with the session seed and round settings */
+	void BeginReplay();
+
+	/** Writes the replay recording next to the session log */
+	void SaveReplay();
+
+	/** Writes the player's weapon, if it changed, and their location and view rotation to the replay */
+	void WriteReplayKeyframe();
+
+	/** Pins the view of a shot down in the replay, so every shot of a full auto burst plays back the same */
+	void WriteShotKeyframe();
+
+	/** Adds a shot to the replicated event ring */
+	void PushShotEvent(const FVector& ImpactPoint, bool bHit);
+
+	/** Adds a target spawn to the replicated event ring */
+	void PushSpawnEvent(const FVector& Location);
+
+	/** Shows the new round state to the owning player */
+	UFUNCTION()
+	void OnRep_RoundState();
+
+	/** Updates the owning player's cursor and start button for the current round state */
+	void PresentRoundState();
+
+	/** Broadcasts the shots that arrived since the last update */
+	UFUNCTION()
+	void OnRep_ShotSequence();
+
+	/** Broadcasts the spawns that arrived since the last update */
+	UFUNCTION()
+	void OnRep_SpawnSequence();
+
+	/** Returns the best estimate of the server's world time */
+	double GetServerTime() const;
+
+	/** Moves the player back to a player start with fresh HP, or respawns them if they're dead */
+	void ResetPlayer();
+
+public:
+
+	// Accuracy tracking
+	int32 SuccessfulHits = 0;
+	int32 MissedShots = 0;
+	float Accuracy = 0.f;
+	float AvgReactionTime = 0.f;
+	float AvgReactionTimeCorrected = 0.f;
+
+	// Average reaction time tracking, the spawn and hit time of every target hit, paired by index
+	TArray<float> TargetSpawnTimes;
+	TArray<float> TargetShotTimes;
+
+	// Frame timing at each target spawn and hit, parallel to the time arrays
+	TArray<FShooterFrameTiming> TargetSpawnTimings;
+	TArray<FShooterFrameTiming> TargetShotTimings;
+
+	/** Called when a new target is spawned */
+	FShooterTargetSpawnedDelegate OnShooterTargetSpawned;
+
+	/** Called when a round ends, after its summary was exported */
+	FShooterRoundEndedDelegate OnShooterRoundEnded;
+
+	/** Called after the last round has ended and the session summary was exported */
+	FShooterSessionFinishedDelegate OnShooterSessionFinished;
+
+	/** Called on the owning client for every replicated shot, with its reconstructed server time */
+	FShooterShotReplicatedDelegate OnShotReplicated;
+
+	/** Called on the owning client for every replicated target spawn, with its reconstructed server time */
+	FShooterSpawnReplicatedDelegate OnSpawnReplicated;
+
+	/** Sets up the owner only, push model replication of the event rings */
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Starts the next round if we're waiting for it */
+	void StartRound();
+
+	/** Restores the round flow, target spawners, telemetry and player to their initial state without reloading the level */
+	void ResetSession();
+
+	/** Returns the current state of the round flow */
+	EShooterRoundState GetRoundState() const { return RoundState; }
+
+	/** Returns the round config in use */
+	const UShooterRoundConfig* GetRoundConfig() const;
+
+	/** Sets whether rounds start on their own. Starts a pending round right away */
+	void SetAutoStartRounds(bool bAutoStart);
+
+	/** Returns the player training in this session */
+	APlayerController* GetPlayerController() const { return PlayerController; }
+
+	/** Returns the UI widget, if this session belongs to a local player */
+	UShooterUI* GetShooterUI() const { return ShooterUI; }
+
+	/** Returns the most recently spawned target if it's still up */
+	AActor* GetCurrentTarget() const { return CurrentTarget.Get(); }
+
+	/** Returns the telemetry log for this session */
+	FShooterSessionLog& GetSessionLog() { return SessionLog; }
+
+	/** Appends the standard quantiles of a sketch to a log line */
+	static void AppendQuantiles(FStringBuilderBase& Line, const FShooterQuantileSketch& Sketch);
+
+	/** Returns true if the player's fire and look input should be processed. The world keeps running between rounds */
+	bool IsCombatInputAllowed() const { return RoundState == EShooterRoundState::InRound; }
+
+	/** Returns the seconds left in the current timed state, or zero */
+	float GetStateTimeRemaining() const;
+
+	/** Sets the seed the spawn schedules are derived from. Takes effect from the next round that gets prepared */
+	void SetSessionSeed(int32 InSessionSeed) { SessionSeed = InSessionSeed; }
+
+	/** Returns the seed the spawn schedules are derived from */
+	int32 GetSessionSeed() const { return SessionSeed; }
+
+	/** Returns the time since the replay recording started */
+	double GetReplayTime() const;
+
+	/** Called by the player's character for every aim input that passes the round gate */
+	void RecordAimInput(float Yaw, float Pitch);
+
+	/** Called by the player's character when the fire input is pressed or released */
+	void RecordFireInput(bool bPressed);
+
+	/** Logs how long a session reset took */
+	void LogResetTime(const TCHAR* ResetType, double Milliseconds);
+
+	/** Called by target spawners when a new target has been spawned */
+	void OnTargetSpawned(AActor* Target);
+
+	/** Called by target spawners when a target is taken down without being hit */
+	void OnTargetWithdrawn(AActor* Target);
+
+	/** Called by weapons when a shot hits a target. Only shots by the session's own pawn are scored and recorded */
+	void OnTargetHit(const APawn* Shooter, AActor* Target, const FVector& ImpactPoint);
+
+	/** Called by weapons when a shot misses. Only shots by the session's own pawn are scored and recorded */
+	void OnShotMissed(const APawn* Shooter, const FVector& ImpactPoint);
+
+	/** Returns true if the pawn is the one this session's player is playing with */
+	bool IsSessionPawn(const APawn* Pawn) const;
+};
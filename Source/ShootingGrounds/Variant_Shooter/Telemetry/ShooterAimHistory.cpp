@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterAimHistory.h"
+#include "HAL/PlatformTime.h"
+
+namespace ShooterAimHistory
+{
+	/** Aim deltas are stored in thousandths of an input unit */
+	constexpr float AngleScale = 1000.0f;
+
+	/** Timestamps are stored in microseconds */
+	constexpr double TimeScale = 1000000.0;
+
+	/** Worst case encoded size of a sample: three 32 bit varints */
+	constexpr uint32 MaxSampleBytes = 15;
+
+	/** Maps signed deltas to unsigned so small negative values stay short */
+	FORCEINLINE uint32 ZigZag(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	/** Reverses ZigZag */
+	FORCEINLINE int32 UnZigZag(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+
+	/** Wrapping subtraction so extreme inputs never overflow */
+	FORCEINLINE int32 WrappingDelta(int32 Value, int32 Base)
+	{
+		return static_cast<int32>(static_cast<uint32>(Value) - static_cast<uint32>(Base));
+	}
+
+	/** Wrapping addition, reverses WrappingDelta */
+	FORCEINLINE int32 WrappingAdd(int32 Base, int32 Delta)
+	{
+		return static_cast<int32>(static_cast<uint32>(Base) + static_cast<uint32>(Delta));
+	}
+}
+
+FShooterAimHistory::FShooterAimHistory(int32 InCapacityBytes)
+{
+	Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InCapacityBytes, 64)));
+	Mask = Capacity - 1;
+}
+
+void FShooterAimHistory::BeginSegment(uint64 TimestampCycles)
+{
+	// reset the cursors. The buffer allocation is kept
+	Head = Tail = 0;
+
+	HeadTime = TailTime = 0;
+	HeadYaw = TailYaw = 0;
+	HeadPitch = TailPitch = 0;
+
+	NumSamples = 0;
+	NumDropped = 0;
+
+	SegmentStartCycles = TimestampCycles;
+	bHasSegment = true;
+}
+
+void FShooterAimHistory::Record(uint64 TimestampCycles, float Yaw, float Pitch)
+{
+	using namespace ShooterAimHistory;
+
+	// allocate the buffer on first use
+	if (Buffer.Num() == 0)
+	{
+		Buffer.SetNumUninitialized(Capacity);
+	}
+
+	// without a segment, the elapsed time would be measured from boot and overflow the 32 bit timestamps
+	if (!bHasSegment)
+	{
+		BeginSegment(TimestampCycles);
+	}
+
+	// quantize the sample. Timestamps are clamped to never go back, so the time delta can't underflow
+	const uint64 ElapsedCycles = TimestampCycles > SegmentStartCycles ? TimestampCycles - SegmentStartCycles : 0;
+	const double ElapsedMicroseconds = FPlatformTime::ToSeconds64(ElapsedCycles) * TimeScale;
+	const uint32 Time = FMath::Max(HeadTime, static_cast<uint32>(FMath::Min(ElapsedMicroseconds, static_cast<double>(MAX_uint32))));
+	const int32 QuantYaw = FMath::RoundToInt32(Yaw * AngleScale);
+	const int32 QuantPitch = FMath::RoundToInt32(Pitch * AngleScale);
+
+	// make room for the worst case sample size
+	while (Head - Tail > Capacity - MaxSampleBytes)
+	{
+		DropOldest();
+	}
+
+	// encode the deltas from the previous sample
+	WriteVarint(Time - HeadTime);
+	WriteVarint(ZigZag(WrappingDelta(QuantYaw, HeadYaw)));
+	WriteVarint(ZigZag(WrappingDelta(QuantPitch, HeadPitch)));
+
+	HeadTime = Time;
+	HeadYaw = QuantYaw;
+	HeadPitch = QuantPitch;
+
+	++NumSamples;
+}
+
+void FShooterAimHistory::DropOldest()
+{
+	using namespace ShooterAimHistory;
+
+	// decode the oldest sample so the next one can be decoded against it
+	TailTime += ReadVarint(Tail);
+	TailYaw = WrappingAdd(TailYaw, UnZigZag(ReadVarint(Tail)));
+	TailPitch = WrappingAdd(TailPitch, UnZigZag(ReadVarint(Tail)));
+
+	--NumSamples;
+	++NumDropped;
+}
+
+void FShooterAimHistory::Decode(TArray<FShooterAimSample>& OutSamples) const
+{
+	using namespace ShooterAimHistory;
+
+	OutSamples.Reset(NumSamples);
+
+	uint32 Cursor = Tail;
+	uint32 Time = TailTime;
+	int32 QuantYaw = TailYaw;
+	int32 QuantPitch = TailPitch;
+
+	for (int32 i = 0; i < NumSamples; ++i)
+	{
+		Time += ReadVarint(Cursor);
+		QuantYaw = WrappingAdd(QuantYaw, UnZigZag(ReadVarint(Cursor)));
+		QuantPitch = WrappingAdd(QuantPitch, UnZigZag(ReadVarint(Cursor)));
+
+		FShooterAimSample& Sample = OutSamples.AddDefaulted_GetRef();
+		Sample.Time = Time / TimeScale;
+		Sample.Yaw = QuantYaw / AngleScale;
+		Sample.Pitch = QuantPitch / AngleScale;
+	}
+}
@@ -0,0 +1,123 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  A single decoded aim input sample
+ */
+struct FShooterAimSample
+{
+	/** Time since the start of the segment, in seconds */
+	double Time = 0.0;
+
+	/** Yaw input delta */
+	float Yaw = 0.0f;
+
+	/** Pitch input delta */
+	float Pitch = 0.0f;
+};
+
+/**
+ *  Fixed size ring buffer of aim input samples
+ *  Each sample is stored as varint encoded deltas from the previous one, so a typical mouse sample takes 3 to 5 bytes
+ *  When the buffer fills up, the oldest samples are dropped to make room for new ones
+ *  The buffer memory is only allocated once the first sample is recorded
+ */
+class SHOOTINGGROUNDS_API FShooterAimHistory
+{
+public:
+
+	/** Constructor. Capacity is rounded up to a power of two */
+	explicit FShooterAimHistory(int32 InCapacityBytes = 16 * 1024);
+
+	/** Drops all samples and starts a new segment. Timestamp is in FPlatformTime cycles */
+	void BeginSegment(uint64 TimestampCycles);
+
+	/** Records an aim sample. Timestamp is in FPlatformTime cycles. Starts a segment at the sample if none was started */
+	void Record(uint64 TimestampCycles, float Yaw, float Pitch);
+
+	/** Decodes all samples in the current segment, oldest first */
+	void Decode(TArray<FShooterAimSample>& OutSamples) const;
+
+	/** Returns the number of samples currently held */
+	int32 Num() const { return NumSamples; }
+
+	/** Returns the number of samples dropped from the current segment due to overflow */
+	int32 GetNumDropped() const { return NumDropped; }
+
+protected:
+
+	/** Drops the oldest sample and rebases the decoder on the next one */
+	void DropOldest();
+
+	/** Appends a varint to the buffer */
+	FORCEINLINE void WriteVarint(uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Buffer[Head++ & Mask] = static_cast<uint8>(Value | 0x80);
+			Value >>= 7;
+		}
+
+		Buffer[Head++ & Mask] = static_cast<uint8>(Value);
+	}
+
+	/** Reads a varint from the buffer at the cursor and advances it */
+	FORCEINLINE uint32 ReadVarint(uint32& Cursor) const
+	{
+		uint32 Value = 0;
+		uint32 Shift = 0;
+		uint8 Byte;
+
+		do
+		{
+			Byte = Buffer[Cursor++ & Mask];
+			Value |= static_cast<uint32>(Byte & 0x7F) << Shift;
+			Shift += 7;
+
+		} while (Byte & 0x80);
+
+		return Value;
+	}
+
+protected:
+
+	/** Encoded sample storage */
+	TArray<uint8> Buffer;
+
+	/** Buffer size in bytes. Always a power of two */
+	uint32 Capacity = 0;
+
+	/** Index mask for the ring buffer */
+	uint32 Mask = 0;
+
+	/** Write position. Wraps around through the mask */
+	uint32 Head = 0;
+
+	/** Position of the oldest sample */
+	uint32 Tail = 0;
+
+	/** Cycle count at the start of the segment */
+	uint64 SegmentStartCycles = 0;
+
+	/** True once a segment has been started */
+	bool bHasSegment = false;
+
+	/** Quantized values of the newest sample, used as the encoding base */
+	uint32 HeadTime = 0;
+	int32 HeadYaw = 0;
+	int32 HeadPitch = 0;
+
+	/** Quantized values preceding the oldest sample, used as the decoding base */
+	uint32 TailTime = 0;
+	int32 TailYaw = 0;
+	int32 TailPitch = 0;
+
+	/** Number of samples currently held */
+	int32 NumSamples = 0;
+
+	/** Number of samples dropped from this segment */
+	int32 NumDropped = 0;
+};
@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterFrameTiming.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "CoreGlobals.h"
+#include "RHI.h"
+#include "Misc/CoreDelegates.h"
+
+namespace ShooterFrameTiming
+{
+	/** Wall clock time the current frame started at, in seconds. Zero until the first frame is seen */
+	double FrameStartSeconds = 0.0;
+
+	/** Wall clock duration of the last completed frame, in seconds */
+	double FrameSeconds = 0.0;
+
+	/** Starts tracking frame boundaries in wall clock time */
+	void EnsureFrameHook()
+	{
+		static bool bHooked = false;
+
+		if (bHooked)
+		{
+			return;
+		}
+
+		bHooked = true;
+
+		FCoreDelegates::OnBeginFrame.AddLambda([]()
+		{
+			const double Now = FPlatformTime::Seconds();
+
+			if (FrameStartSeconds > 0.0)
+			{
+				FrameSeconds = Now - FrameStartSeconds;
+			}
+
+			FrameStartSeconds = Now;
+		});
+	}
+}
+
+FShooterFrameTiming FShooterFrameTiming::Capture()
+{
+	using namespace ShooterFrameTiming;
+
+	EnsureFrameHook();
+
+	FShooterFrameTiming Timing;
+
+	// engine time runs at a fixed step under -benchmark and fixed frame rates, so use wall clock frame boundaries.
+	// Until the first frame boundary is seen, fall back to the engine's
+	const double Now = FPlatformTime::Seconds();
+	const double FrameStart = FrameStartSeconds > 0.0 ? FrameStartSeconds : FApp::GetCurrentTime();
+
+	Timing.DeltaTime = static_cast<float>(FrameSeconds > 0.0 ? FrameSeconds : FApp::GetDeltaTime());
+
+	// thread times are published in cycles for the last completed frame
+	Timing.GameThreadTime = static_cast<float>(FPlatformTime::ToSeconds(GGameThreadTime));
+	Timing.RenderThreadTime = static_cast<float>(FPlatformTime::ToSeconds(GRenderThreadTime));
+	Timing.GPUTime = static_cast<float>(FPlatformTime::ToSeconds(RHIGetGPUFrameCycles()));
+
+	// the frame still has to finish on the game thread, then go through the render thread and the GPU
+	const float FrameElapsed = static_cast<float>(FMath::Max(0.0, Now - FrameStart));
+	Timing.DisplayLatency = FMath::Max(Timing.GameThreadTime, FrameElapsed) + Timing.RenderThreadTime + Timing.GPUTime;
+
+	// input is polled once per frame, so on average it waits half a frame before being processed
+	Timing.InputLatency = Timing.DeltaTime * 0.5f + Timing.DisplayLatency;
+
+	return Timing;
+}
+
+float FShooterFrameTiming::CorrectReactionTime(float RawReactionTime, const FShooterFrameTiming& SpawnTiming, const FShooterFrameTiming& ShotTiming)
+{
+	return FMath::Max(0.0f, RawReactionTime - SpawnTiming.DisplayLatency - ShotTiming.DeltaTime * 0.5f);
+}
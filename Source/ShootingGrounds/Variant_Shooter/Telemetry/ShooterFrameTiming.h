@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Frame timing snapshot attached to spawn and shot records
+ *  Lets reaction times be compared across machines running at different frame rates
+ */
+struct SHOOTINGGROUNDS_API FShooterFrameTiming
+{
+	/** Wall clock duration of the last completed frame, in seconds */
+	float DeltaTime = 0.0f;
+
+	/** Game thread time of the last completed frame, in seconds */
+	float GameThreadTime = 0.0f;
+
+	/** Render thread time of the last completed frame, in seconds */
+	float RenderThreadTime = 0.0f;
+
+	/** GPU time of the last completed frame, in seconds. Zero when running without a GPU */
+	float GPUTime = 0.0f;
+
+	/** Estimated time from the start of this frame until it is displayed, in seconds */
+	float DisplayLatency = 0.0f;
+
+	/** Estimated time from an input event until the frame that processes it is displayed, in seconds */
+	float InputLatency = 0.0f;
+
+	/** Captures the timing for the current frame */
+	static FShooterFrameTiming Capture();
+
+	/**
+	 *  Removes frame pacing from a raw reaction time
+	 *  The target only becomes visible once its spawn frame is displayed,
+	 *  and the shot input happened on average half a frame before it was polled
+	 */
+	static float CorrectReactionTime(float RawReactionTime, const FShooterFrameTiming& SpawnTiming, const FShooterFrameTiming& ShotTiming);
+};
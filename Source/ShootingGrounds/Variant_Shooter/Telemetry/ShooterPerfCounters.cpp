@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterPerfCounters.h"
+
+FShooterPerfCounters::FAtomicCounter FShooterPerfCounters::Counters[static_cast<uint8>(EShooterPerfScope::Num)];
+
+std::atomic<bool> FShooterPerfCounters::bEnabled{false};
+
+FShooterPerfCounters::FCounter FShooterPerfCounters::Get(EShooterPerfScope Scope)
+{
+	const FAtomicCounter& Counter = Counters[static_cast<uint8>(Scope)];
+
+	FCounter Result;
+	Result.Cycles = Counter.Cycles.load(std::memory_order_relaxed);
+	Result.Calls = Counter.Calls.load(std::memory_order_relaxed);
+	return Result;
+}
+
+void FShooterPerfCounters::Reset()
+{
+	for (FAtomicCounter& Counter : Counters)
+	{
+		Counter.Cycles.store(0, std::memory_order_relaxed);
+		Counter.Calls.store(0, std::memory_order_relaxed);
+	}
+}
+
+const TCHAR* FShooterPerfCounters::GetScopeName(EShooterPerfScope Scope)
+{
+	switch (Scope)
+	{
+	case EShooterPerfScope::WeaponFire:		return TEXT("WeaponFire");
+	case EShooterPerfScope::GunTrace:		return TEXT("GunTrace");
+	case EShooterPerfScope::SpawnTarget:	return TEXT("SpawnTarget");
+	case EShooterPerfScope::LineOfSight:	return TEXT("LineOfSight");
+	case EShooterPerfScope::LineOfSightCache:	return TEXT("LineOfSightCache");
+	case EShooterPerfScope::SenseEnemies:	return TEXT("SenseEnemies");
+	case EShooterPerfScope::NPCAim:			return TEXT("NPCAim");
+	case EShooterPerfScope::ExplosionCheck:	return TEXT("ExplosionCheck");
+	case EShooterPerfScope::NPCSignificance:	return TEXT("NPCSignificance");
+	case EShooterPerfScope::NPCCrowd:	return TEXT("NPCCrowd");
+	case EShooterPerfScope::TeamPerception:	return TEXT("TeamPerception");
+	case EShooterPerfScope::RagdollBudget:	return TEXT("RagdollBudget");
+	case EShooterPerfScope::NPCEvents:	return TEXT("NPCEvents");
+	case EShooterPerfScope::TargetReady:	return TEXT("TargetReady");
+	case EShooterPerfScope::NPCStateTree:	return TEXT("NPCStateTree");
+	default:								return TEXT("Unknown");
+	}
+}
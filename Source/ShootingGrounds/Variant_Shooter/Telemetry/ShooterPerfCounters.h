@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include <atomic>
+
+/**
+ *  Instrumented scopes, named after their SHOOTER_SCOPE_STAT stat
+ *  TargetReady isn't a scope. It's the time from a target spawn request to the first frame the target is shootable
+ */
+enum class EShooterPerfScope : uint8
+{
+	WeaponFire,
+	GunTrace,
+	SpawnTarget,
+	LineOfSight,
+	LineOfSightCache,
+	SenseEnemies,
+	NPCAim,
+	ExplosionCheck,
+	NPCSignificance,
+	NPCCrowd,
+	TeamPerception,
+	RagdollBudget,
+	NPCEvents,
+	TargetReady,
+	NPCStateTree,
+
+	Num
+};
+
+/**
+ *  Always available cycle and call counters for the instrumented scopes
+ *  Unlike the stat group these work in any build configuration and can be read back by gameplay code,
+ *  which lets the benchmark mode of the session runner check them against budgets
+ *  Counting is off by default and costs a single branch per scope until enabled
+ */
+class SHOOTINGGROUNDS_API FShooterPerfCounters
+{
+public:
+
+	/** Totals for a single scope */
+	struct FCounter
+	{
+		uint64 Cycles = 0;
+		uint64 Calls = 0;
+
+		/** Returns the average cost per call in microseconds */
+		double GetMicrosecondsPerCall() const { return Calls > 0 ? FPlatformTime::ToMilliseconds64(Cycles) * 1000.0 / Calls : 0.0; }
+	};
+
+	/** Starts or stops counting */
+	static void SetEnabled(bool bEnable) { bEnabled.store(bEnable, std::memory_order_relaxed); }
+
+	/** Returns true if scopes are being counted */
+	static FORCEINLINE bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+	/** Adds a timed call to a scope */
+	static FORCEINLINE void Add(EShooterPerfScope Scope, uint64 Cycles)
+	{
+		FAtomicCounter& Counter = Counters[static_cast<uint8>(Scope)];
+		Counter.Cycles.fetch_add(Cycles, std::memory_order_relaxed);
+		Counter.Calls.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/** Returns the totals for a scope */
+	static FCounter Get(EShooterPerfScope Scope);
+
+	/** Clears all counters */
+	static void Reset();
+
+	/** Returns the display name of a scope */
+	static const TCHAR* GetScopeName(EShooterPerfScope Scope);
+
+protected:
+
+	/** Thread safe storage for a counter. Scopes may run off the game thread */
+	struct FAtomicCounter
+	{
+		std::atomic<uint64> Cycles{0};
+		std::atomic<uint64> Calls{0};
+	};
+
+	static FAtomicCounter Counters[static_cast<uint8>(EShooterPerfScope::Num)];
+
+	static std::atomic<bool> bEnabled;
+};
+
+/**
+ *  Adds the time spent in the enclosing scope to a perf counter, if counting is enabled
+ */
+class FShooterPerfScopeTimer
+{
+public:
+
+	FORCEINLINE explicit FShooterPerfScopeTimer(EShooterPerfScope InScope)
+		: Scope(InScope)
+		, StartCycles(FShooterPerfCounters::IsEnabled() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	FORCEINLINE ~FShooterPerfScopeTimer()
+	{
+		if (StartCycles != 0)
+		{
+			FShooterPerfCounters::Add(Scope, FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+
+	EShooterPerfScope Scope;
+	uint64 StartCycles;
+};
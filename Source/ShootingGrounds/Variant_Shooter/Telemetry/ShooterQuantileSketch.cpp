@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterQuantileSketch.h"
+
+namespace ShooterQuantileSketch
+{
+	/** Values are stored in microseconds */
+	constexpr double TimeScale = 1000000.0;
+}
+
+FShooterQuantileSketch::FShooterQuantileSketch()
+{
+	Reset();
+}
+
+void FShooterQuantileSketch::Record(double Seconds)
+{
+	const uint32 Value = static_cast<uint32>(FMath::Clamp(Seconds * ShooterQuantileSketch::TimeScale, 0.0, static_cast<double>(MAX_uint32)));
+
+	++Buckets[GetBucketIndex(Value)];
+
+	++Count;
+	Sum += Value;
+	Min = FMath::Min(Min, Value);
+	Max = FMath::Max(Max, Value);
+}
+
+void FShooterQuantileSketch::Merge(const FShooterQuantileSketch& Other)
+{
+	for (uint32 i = 0; i < NumBuckets; ++i)
+	{
+		Buckets[i] += Other.Buckets[i];
+	}
+
+	Count += Other.Count;
+	Sum += Other.Sum;
+	Min = FMath::Min(Min, Other.Min);
+	Max = FMath::Max(Max, Other.Max);
+}
+
+void FShooterQuantileSketch::Reset()
+{
+	FMemory::Memzero(Buckets);
+
+	Count = 0;
+	Sum = 0;
+	Min = MAX_uint32;
+	Max = 0;
+}
+
+double FShooterQuantileSketch::GetQuantile(double Quantile) const
+{
+	if (Count == 0)
+	{
+		return 0.0;
+	}
+
+	// find the rank of the requested value
+	const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(FMath::Clamp(Quantile, 0.0, 1.0) * Count)));
+
+	// walk the buckets until we reach the rank
+	uint64 Accumulated = 0;
+
+	for (uint32 i = 0; i < NumBuckets; ++i)
+	{
+		Accumulated += Buckets[i];
+
+		if (Accumulated >= Rank)
+		{
+			// the bucket midpoint can't be outside the exact recorded range
+			const double Value = FMath::Clamp(GetBucketMidpoint(i), static_cast<double>(Min), static_cast<double>(Max));
+			return Value / ShooterQuantileSketch::TimeScale;
+		}
+	}
+
+	return GetMax();
+}
+
+double FShooterQuantileSketch::GetMean() const
+{
+	return Count > 0 ? (static_cast<double>(Sum) / Count) / ShooterQuantileSketch::TimeScale : 0.0;
+}
+
+double FShooterQuantileSketch::GetMin() const
+{
+	return Count > 0 ? Min / ShooterQuantileSketch::TimeScale : 0.0;
+}
+
+double FShooterQuantileSketch::GetMax() const
+{
+	return Max / ShooterQuantileSketch::TimeScale;
+}
+
+double FShooterQuantileSketch::GetBucketMidpoint(uint32 Index)
+{
+	// linear buckets hold a single value
+	if (Index < SubBucketCount)
+	{
+		return Index;
+	}
+
+	// recover the shift and the top bits of the value
+	const uint32 Shift = Index / SubBucketHalfCount - 1;
+	const uint64 Lower = static_cast<uint64>(Index - Shift * SubBucketHalfCount) << Shift;
+	const uint64 Width = uint64(1) << Shift;
+
+	return Lower + (Width - 1) * 0.5;
+}
@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Constant memory streaming histogram for timing values, in the style of an HDR histogram
+ *  Values are stored in microseconds in log-linear buckets with 32 sub-buckets per power of two past the first 64us,
+ *  giving under 2% relative error on reported quantiles for values from 1us to over an hour
+ *  Recording is O(1) and sketches can be merged by adding their buckets
+ */
+class SHOOTINGGROUNDS_API FShooterQuantileSketch
+{
+public:
+
+	/** Number of significant bits kept per value. The leading one is implied, so each power of two gets SubBucketHalfCount buckets */
+	static constexpr uint32 SubBucketBits = 6;
+
+	/** Number of buckets per power of two in the linear range */
+	static constexpr uint32 SubBucketCount = 1 << SubBucketBits;
+
+	/** Number of buckets added per additional power of two */
+	static constexpr uint32 SubBucketHalfCount = SubBucketCount / 2;
+
+	/** Total number of buckets needed to cover 32 bit microsecond values */
+	static constexpr uint32 NumBuckets = (32 - SubBucketBits + 1) * SubBucketHalfCount + SubBucketHalfCount;
+
+public:
+
+	/** Constructor */
+	FShooterQuantileSketch();
+
+	/** Records a value in seconds. Negative values are clamped to zero */
+	void Record(double Seconds);
+
+	/** Adds all the values recorded by another sketch to this one */
+	void Merge(const FShooterQuantileSketch& Other);
+
+	/** Clears all recorded values */
+	void Reset();
+
+	/** Returns the value at the given quantile in seconds. Quantile is in the [0, 1] range */
+	double GetQuantile(double Quantile) const;
+
+	/** Returns the number of recorded values */
+	uint64 GetCount() const { return Count; }
+
+	/** Returns the exact mean of the recorded values in seconds */
+	double GetMean() const;
+
+	/** Returns the exact minimum recorded value in seconds */
+	double GetMin() const;
+
+	/** Returns the exact maximum recorded value in seconds */
+	double GetMax() const;
+
+protected:
+
+	/** Returns the bucket index for a value in microseconds */
+	static FORCEINLINE uint32 GetBucketIndex(uint32 Value)
+	{
+		// small values map to the linear buckets directly
+		if (Value < SubBucketCount)
+		{
+			return Value;
+		}
+
+		// keep the top SubBucketBits bits of the value
+		const uint32 Shift = FMath::FloorLog2(Value) - (SubBucketBits - 1);
+		return Shift * SubBucketHalfCount + (Value >> Shift);
+	}
+
+	/** Returns the value at the middle of the given bucket, in microseconds */
+	static double GetBucketMidpoint(uint32 Index);
+
+protected:
+
+	/** Value counts per bucket */
+	uint32 Buckets[NumBuckets];
+
+	/** Total number of recorded values */
+	uint64 Count = 0;
+
+	/** Sum of all recorded values, in microseconds */
+	uint64 Sum = 0;
+
+	/** Smallest recorded value, in microseconds */
+	uint32 Min = MAX_uint32;
+
+	/** Largest recorded value, in microseconds */
+	uint32 Max = 0;
+};
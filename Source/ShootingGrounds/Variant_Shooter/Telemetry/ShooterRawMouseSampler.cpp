@@ -0,0 +1,37 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterRawMouseSampler.h"
+#include "Input/Events.h"
+#include "HAL/PlatformTime.h"
+
+bool FShooterRawMouseSampler::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	const FVector2D Delta = MouseEvent.GetCursorDelta();
+
+	// nothing to record for synthetic moves
+	if (Delta.IsZero())
+	{
+		return false;
+	}
+
+	// nobody is consuming, so the oldest moves are stale anyway
+	if (Samples.Num() >= MaxSamples)
+	{
+		Samples.Reset();
+	}
+
+	FShooterRawMouseSample& Sample = Samples.AddDefaulted_GetRef();
+	Sample.ArrivalCycles = FPlatformTime::Cycles64();
+	Sample.DeltaX = Delta.X;
+	Sample.DeltaY = Delta.Y;
+
+	// let the move through to the regular input path
+	return false;
+}
+
+void FShooterRawMouseSampler::ConsumeSamples(TArray<FShooterRawMouseSample>& OutSamples)
+{
+	OutSamples.Reset();
+	Swap(OutSamples, Samples);
+}
@@ -0,0 +1,57 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/Application/IInputProcessor.h"
+
+/**
+ *  A single raw mouse move, as reported by the device
+ */
+struct FShooterRawMouseSample
+{
+	/** Time the move was handed to the application, in FPlatformTime cycles. Moves delivered by the same message pump share it */
+	uint64 ArrivalCycles = 0;
+
+	/** Horizontal movement in device counts */
+	float DeltaX = 0.0f;
+
+	/** Vertical movement in device counts. Positive is down */
+	float DeltaY = 0.0f;
+};
+
+/**
+ *  Slate input preprocessor that keeps every mouse move it sees
+ *  Enhanced Input only gets the mouse movement summed over the frame, so a 1000 Hz mouse is reduced to one sample per frame.
+ *  The preprocessor sees each move as the platform reports it, before the per frame accumulation, so the individual moves
+ *  and their order are kept. Their timing isn't: the platform doesn't pass the device timestamps on and the moves are
+ *  pumped once per frame, so all of a frame's moves arrive at about the same time. Don't read sub frame timing into them.
+ *  Moves are never consumed, so the regular input path is unaffected
+ */
+class SHOOTINGGROUNDS_API FShooterRawMouseSampler : public IInputProcessor
+{
+public:
+
+	//~Begin IInputProcessor interface
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override {}
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	virtual const TCHAR* GetDebugName() const override { return TEXT("ShooterRawMouseSampler"); }
+	//~End IInputProcessor interface
+
+	/** Returns true if moves arrived since the samples were last consumed */
+	bool HasSamples() const { return Samples.Num() > 0; }
+
+	/** Hands the samples collected so far to the caller, oldest first. Both arrays keep their allocations */
+	void ConsumeSamples(TArray<FShooterRawMouseSample>& OutSamples);
+
+	/** Drops the samples nobody consumed, like moves made while the cursor was free */
+	void DiscardSamples() { Samples.Reset(); }
+
+protected:
+
+	/** Samples collected since the last consume */
+	TArray<FShooterRawMouseSample> Samples;
+
+	/** Upper bound on the samples held, in case they stop being consumed. A few seconds of a 1000 Hz mouse */
+	static constexpr int32 MaxSamples = 4096;
+};
@@ -0,0 +1,317 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterReplay.h"
+#include "Misc/FileHelper.h"
+#include "ShootingGrounds.h"
+
+namespace ShooterReplay
+{
+	/** Identifies replay files, "SGRP" */
+	constexpr uint32 Magic = 0x50524753;
+
+	/** Bumped whenever the encoding changes */
+	constexpr uint8 Version = 1;
+
+	/** Aim deltas are stored in thousandths of an input unit, like the aim history */
+	constexpr float AngleScale = 1000.0f;
+
+	/** Record types take the low bits of the record header, the time delta the rest */
+	constexpr uint32 TypeBits = 3;
+
+	/** Maps signed values to unsigned so small negative values stay short */
+	FORCEINLINE uint32 ZigZag(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	/** Reverses ZigZag */
+	FORCEINLINE int32 UnZigZag(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+
+	/** Converts seconds to whole milliseconds */
+	FORCEINLINE uint32 ToMs(double Seconds)
+	{
+		return static_cast<uint32>(FMath::Clamp(FMath::RoundToInt64(Seconds * 1000.0), 0ll, static_cast<int64>(MAX_uint32)));
+	}
+
+	/** Bounds checked cursor over an encoded replay */
+	struct FCursor
+	{
+		const TArray<uint8>& Data;
+		int32 Offset = 0;
+		bool bError = false;
+
+		explicit FCursor(const TArray<uint8>& InData) : Data(InData) {}
+
+		bool AtEnd() const { return Offset >= Data.Num(); }
+
+		uint8 ReadByte()
+		{
+			if (Offset >= Data.Num())
+			{
+				bError = true;
+				return 0;
+			}
+
+			return Data[Offset++];
+		}
+
+		uint32 ReadVarint()
+		{
+			uint32 Value = 0;
+
+			for (uint32 Shift = 0; Shift < 35; Shift += 7)
+			{
+				const uint8 Byte = ReadByte();
+				Value |= static_cast<uint32>(Byte & 0x7f) << Shift;
+
+				if ((Byte & 0x80) == 0)
+				{
+					return Value;
+				}
+			}
+
+			bError = true;
+			return Value;
+		}
+
+		int32 ReadSigned()
+		{
+			return UnZigZag(ReadVarint());
+		}
+
+		uint16 ReadShort()
+		{
+			const uint16 Low = ReadByte();
+			return Low | static_cast<uint16>(ReadByte() << 8);
+		}
+	};
+}
+
+void FShooterReplayWriter::Begin(const FShooterReplayHeader& Header)
+{
+	using namespace ShooterReplay;
+
+	Buffer.Reset();
+	LastTimeMs = 0;
+	bRecording = true;
+
+	WriteVarint(Magic);
+	Buffer.Add(Version);
+
+	// the seeds and round settings rebuild the spawn schedule, so target spawns never need to be stored
+	WriteVarint(static_cast<uint32>(Header.SessionSeed));
+	WriteVarint(ToMs(Header.IntermissionDuration));
+	WriteVarint(Header.Rounds.Num());
+
+	for (const FShooterReplayRound& Round : Header.Rounds)
+	{
+		WriteVarint(ToMs(Round.Duration));
+		WriteVarint(static_cast<uint32>(Round.SpawnSeed));
+	}
+}
+
+void FShooterReplayWriter::WriteAim(double Time, float Yaw, float Pitch)
+{
+	using namespace ShooterReplay;
+
+	WriteRecordHeader(Time, EShooterReplayEvent::Aim);
+	WriteSigned(FMath::RoundToInt32(Yaw * AngleScale));
+	WriteSigned(FMath::RoundToInt32(Pitch * AngleScale));
+}
+
+void FShooterReplayWriter::WriteFire(double Time, bool bPressed)
+{
+	WriteRecordHeader(Time, bPressed ? EShooterReplayEvent::FirePressed : EShooterReplayEvent::FireReleased);
+}
+
+void FShooterReplayWriter::WriteKeyframe(double Time, const FVector& Location, const FRotator& Rotation)
+{
+	WriteRecordHeader(Time, EShooterReplayEvent::Keyframe);
+
+	// whole centimeters are plenty to pull the pawn back in line
+	WriteSigned(FMath::RoundToInt32(Location.X));
+	WriteSigned(FMath::RoundToInt32(Location.Y));
+	WriteSigned(FMath::RoundToInt32(Location.Z));
+
+	// 16 bit view angles, the same precision the engine replicates them with
+	const uint16 Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+	const uint16 Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+	Buffer.Add(Yaw & 0xff);
+	Buffer.Add(Yaw >> 8);
+	Buffer.Add(Pitch & 0xff);
+	Buffer.Add(Pitch >> 8);
+}
+
+void FShooterReplayWriter::WriteRoundStarted(double Time, int32 Round)
+{
+	WriteRecordHeader(Time, EShooterReplayEvent::RoundStarted);
+	WriteVarint(static_cast<uint32>(Round));
+}
+
+void FShooterReplayWriter::WriteWeapon(double Time, const FString& WeaponClassPath)
+{
+	WriteRecordHeader(Time, EShooterReplayEvent::Weapon);
+
+	const FTCHARToUTF8 Utf8(*WeaponClassPath);
+	WriteVarint(static_cast<uint32>(Utf8.Length()));
+	Buffer.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+}
+
+void FShooterReplayWriter::WriteEnd(double Time, int32 Hits, int32 Misses)
+{
+	WriteRecordHeader(Time, EShooterReplayEvent::End);
+	WriteVarint(static_cast<uint32>(Hits));
+	WriteVarint(static_cast<uint32>(Misses));
+}
+
+bool FShooterReplayWriter::Save(const FString& Filename)
+{
+	bRecording = false;
+
+	if (!FFileHelper::SaveArrayToFile(Buffer, *Filename))
+	{
+		UE_LOG(LogShootingGrounds, Error, TEXT("Could not write session replay %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogShootingGrounds, Display, TEXT("Wrote session replay %s (%d bytes)"), *Filename, Buffer.Num());
+	return true;
+}
+
+void FShooterReplayWriter::WriteRecordHeader(double Time, EShooterReplayEvent Type)
+{
+	using namespace ShooterReplay;
+
+	// records are written in time order, so the delta never goes negative. Most fit in a byte or two
+	const uint32 TimeMs = FMath::Max(ToMs(Time), LastTimeMs);
+	WriteVarint(((TimeMs - LastTimeMs) << TypeBits) | static_cast<uint32>(Type));
+	LastTimeMs = TimeMs;
+}
+
+void FShooterReplayWriter::WriteVarint(uint32 Value)
+{
+	while (Value >= 0x80)
+	{
+		Buffer.Add(static_cast<uint8>(Value | 0x80));
+		Value >>= 7;
+	}
+
+	Buffer.Add(static_cast<uint8>(Value));
+}
+
+void FShooterReplayWriter::WriteSigned(int32 Value)
+{
+	WriteVarint(ShooterReplay::ZigZag(Value));
+}
+
+bool FShooterReplayReader::Load(const FString& Filename)
+{
+	using namespace ShooterReplay;
+
+	Header = FShooterReplayHeader();
+	Events.Reset();
+
+	TArray<uint8> Data;
+
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		UE_LOG(LogShootingGrounds, Error, TEXT("Could not read session replay %s"), *Filename);
+		return false;
+	}
+
+	FCursor Cursor(Data);
+
+	if (Cursor.ReadVarint() != Magic || Cursor.ReadByte() != Version)
+	{
+		UE_LOG(LogShootingGrounds, Error, TEXT("%s is not a session replay, or was written by another version"), *Filename);
+		return false;
+	}
+
+	// session settings
+	Header.SessionSeed = static_cast<int32>(Cursor.ReadVarint());
+	Header.IntermissionDuration = Cursor.ReadVarint() / 1000.0f;
+
+	const uint32 NumRounds = Cursor.ReadVarint();
+
+	for (uint32 i = 0; i < NumRounds && !Cursor.bError; ++i)
+	{
+		FShooterReplayRound& Round = Header.Rounds.AddDefaulted_GetRef();
+		Round.Duration = Cursor.ReadVarint() / 1000.0f;
+		Round.SpawnSeed = static_cast<int32>(Cursor.ReadVarint());
+	}
+
+	// records
+	uint64 TimeMs = 0;
+
+	while (!Cursor.AtEnd() && !Cursor.bError)
+	{
+		const uint32 RecordHeader = Cursor.ReadVarint();
+		TimeMs += RecordHeader >> TypeBits;
+
+		FShooterReplayEvent& Event = Events.AddDefaulted_GetRef();
+		Event.Type = static_cast<EShooterReplayEvent>(RecordHeader & ((1u << TypeBits) - 1));
+		Event.Time = TimeMs / 1000.0;
+
+		switch (Event.Type)
+		{
+		case EShooterReplayEvent::Aim:
+			Event.Yaw = Cursor.ReadSigned() / AngleScale;
+			Event.Pitch = Cursor.ReadSigned() / AngleScale;
+			break;
+
+		case EShooterReplayEvent::FirePressed:
+		case EShooterReplayEvent::FireReleased:
+			break;
+
+		case EShooterReplayEvent::Keyframe:
+			Event.Location.X = Cursor.ReadSigned();
+			Event.Location.Y = Cursor.ReadSigned();
+			Event.Location.Z = Cursor.ReadSigned();
+			Event.Rotation.Yaw = FRotator::DecompressAxisFromShort(Cursor.ReadShort());
+			Event.Rotation.Pitch = FRotator::DecompressAxisFromShort(Cursor.ReadShort());
+			break;
+
+		case EShooterReplayEvent::RoundStarted:
+			Event.Round = static_cast<int32>(Cursor.ReadVarint());
+			break;
+
+		case EShooterReplayEvent::Weapon:
+		{
+			const int32 Length = static_cast<int32>(Cursor.ReadVarint());
+
+			if (Length < 0 || Cursor.Offset + Length > Data.Num())
+			{
+				Cursor.bError = true;
+				break;
+			}
+
+			const FUTF8ToTCHAR Path(reinterpret_cast<const ANSICHAR*>(Data.GetData() + Cursor.Offset), Length);
+			Event.WeaponClassPath = FString(Path.Length(), Path.Get());
+			Cursor.Offset += Length;
+			break;
+		}
+
+		case EShooterReplayEvent::End:
+			Event.Hits = static_cast<int32>(Cursor.ReadVarint());
+			Event.Misses = static_cast<int32>(Cursor.ReadVarint());
+			break;
+
+		default:
+			Cursor.bError = true;
+			break;
+		}
+	}
+
+	if (Cursor.bError)
+	{
+		UE_LOG(LogShootingGrounds, Error, TEXT("Session replay %s is corrupt"), *Filename);
+		Events.Reset();
+		return false;
+	}
+
+	return true;
+}
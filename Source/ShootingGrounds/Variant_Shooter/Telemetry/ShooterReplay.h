@@ -0,0 +1,177 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Types of records in a session replay
+ */
+enum class EShooterReplayEvent : uint8
+{
+	/** Aim input delta, as passed to the character */
+	Aim,
+
+	/** Fire input pressed */
+	FirePressed,
+
+	/** Fire input released */
+	FireReleased,
+
+	/** Pawn location and view rotation, to correct drift during playback */
+	Keyframe,
+
+	/** A round was started */
+	RoundStarted,
+
+	/** The player's weapon changed */
+	Weapon,
+
+	/** The session finished. Carries the final score to check the playback against */
+	End
+};
+
+/**
+ *  A single decoded replay record
+ */
+struct FShooterReplayEvent
+{
+	/** Record type */
+	EShooterReplayEvent Type = EShooterReplayEvent::Aim;
+
+	/** Time since the start of the recording, in seconds */
+	double Time = 0.0;
+
+	/** Aim input for Aim records */
+	float Yaw = 0.0f;
+	float Pitch = 0.0f;
+
+	/** Pawn location and view rotation for Keyframe records */
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	/** Round number for RoundStarted records */
+	int32 Round = 0;
+
+	/** Weapon class path for Weapon records */
+	FString WeaponClassPath;
+
+	/** Final score for End records */
+	int32 Hits = 0;
+	int32 Misses = 0;
+};
+
+/**
+ *  Round settings needed to rebuild the recorded session
+ */
+struct FShooterReplayRound
+{
+	/** Length of the round in seconds */
+	float Duration = 0.0f;
+
+	/** Spawn seed from the round config. Zero means the session seed was used */
+	int32 SpawnSeed = 0;
+};
+
+/**
+ *  Everything needed to set up a session that plays out like the recorded one
+ */
+struct FShooterReplayHeader
+{
+	/** Seed the session derived its spawn schedules from */
+	int32 SessionSeed = 0;
+
+	/** Break between rounds in seconds */
+	float IntermissionDuration = 0.0f;
+
+	/** Recorded rounds */
+	TArray<FShooterReplayRound> Rounds;
+};
+
+/**
+ *  Records a training session as its seeds, the player's input stream and keyframes, written periodically and for every shot
+ *  Target spawns aren't stored at all, since the seeded spawn schedules bring them back in the same order
+ *  Records are a varint with the time delta and type, followed by a varint encoded payload,
+ *  so a minute of play usually fits in a few KB
+ */
+class SHOOTINGGROUNDS_API FShooterReplayWriter
+{
+public:
+
+	/** Starts a new recording, dropping any previous one */
+	void Begin(const FShooterReplayHeader& Header);
+
+	/** Returns true between Begin and Save */
+	bool IsRecording() const { return bRecording; }
+
+	/** Records an aim input delta */
+	void WriteAim(double Time, float Yaw, float Pitch);
+
+	/** Records a fire input press or release */
+	void WriteFire(double Time, bool bPressed);
+
+	/** Records the pawn location and view rotation */
+	void WriteKeyframe(double Time, const FVector& Location, const FRotator& Rotation);
+
+	/** Records the start of a round */
+	void WriteRoundStarted(double Time, int32 Round);
+
+	/** Records a weapon change */
+	void WriteWeapon(double Time, const FString& WeaponClassPath);
+
+	/** Records the end of the session with its final score */
+	void WriteEnd(double Time, int32 Hits, int32 Misses);
+
+	/** Writes the recording to disk and stops recording */
+	bool Save(const FString& Filename);
+
+	/** Returns the size of the recording so far */
+	int32 GetNumBytes() const { return Buffer.Num(); }
+
+protected:
+
+	/** Writes the combined time delta and type of a record */
+	void WriteRecordHeader(double Time, EShooterReplayEvent Type);
+
+	/** Appends an unsigned varint */
+	void WriteVarint(uint32 Value);
+
+	/** Appends a signed value as a zigzag varint */
+	void WriteSigned(int32 Value);
+
+protected:
+
+	/** Encoded recording */
+	TArray<uint8> Buffer;
+
+	/** Time of the previous record, in milliseconds */
+	uint32 LastTimeMs = 0;
+
+	/** True while records are being accepted */
+	bool bRecording = false;
+};
+
+/**
+ *  Loads a session replay written by FShooterReplayWriter
+ */
+class SHOOTINGGROUNDS_API FShooterReplayReader
+{
+public:
+
+	/** Loads and decodes a replay file. Returns false if the file is missing or corrupt */
+	bool Load(const FString& Filename);
+
+	/** Returns the recorded session settings */
+	const FShooterReplayHeader& GetHeader() const { return Header; }
+
+	/** Returns the recorded events in time order */
+	const TArray<FShooterReplayEvent>& GetEvents() const { return Events; }
+
+protected:
+
+	/** Recorded session settings */
+	FShooterReplayHeader Header;
+
+	/** Decoded events */
+	TArray<FShooterReplayEvent> Events;
+};
@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterSessionLog.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "ShootingGrounds.h"
+
+FShooterSessionLog::~FShooterSessionLog()
+{
+	Close();
+}
+
+bool FShooterSessionLog::Open(const FString& SessionName)
+{
+	Close();
+
+	Filename = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Telemetry"), SessionName + TEXT(".log"));
+
+	Writer = MakeShareable(IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_AllowRead));
+
+	if (!Writer)
+	{
+		UE_LOG(LogShootingGrounds, Error, TEXT("Could not open session log %s"), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+void FShooterSessionLog::Close()
+{
+	if (Writer)
+	{
+		Flush();
+
+		Writer->Close();
+		Writer.Reset();
+	}
+
+	Buffer.Reset();
+}
+
+void FShooterSessionLog::WriteLine(FStringView Line)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	// the log is written as UTF-8
+	FTCHARToUTF8 Converted(Line.GetData(), Line.Len());
+	Buffer.Append(reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length());
+	Buffer.Add('\n');
+
+	// hand large batches to the background
+	if (Buffer.Num() >= AutoFlushBytes)
+	{
+		FlushAsync();
+	}
+}
+
+void FShooterSessionLog::Flush()
+{
+	FlushAsync();
+	WaitForPendingWrite();
+}
+
+void FShooterSessionLog::FlushAsync()
+{
+	if (!Writer || Buffer.IsEmpty())
+	{
+		return;
+	}
+
+	// the task takes ownership of the buffered lines and runs after the previous write
+	PendingWrite = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Writer = Writer, Data = MoveTemp(Buffer)]() mutable
+		{
+			Writer->Serialize(Data.GetData(), Data.Num());
+			Writer->Flush();
+		},
+		UE::Tasks::Prerequisites(PendingWrite), UE::Tasks::ETaskPriority::BackgroundNormal);
+
+	Buffer.Reset(AutoFlushBytes);
+}
+
+void FShooterSessionLog::WaitForPendingWrite()
+{
+	if (PendingWrite.IsValid())
+	{
+		PendingWrite.Wait();
+		PendingWrite = UE::Tasks::FTask();
+	}
+}
@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+
+/**
+ *  Line based telemetry log for a single training session
+ *  Written to Saved/Telemetry/ so it can be picked up by the player modeling scripts
+ *  Each line starts with a record type followed by comma separated fields
+ *  Lines are buffered in memory and written to disk on background tasks, so gameplay never waits on file IO
+ */
+class SHOOTINGGROUNDS_API FShooterSessionLog
+{
+public:
+
+	/** Buffered bytes that trigger a background write */
+	static constexpr int32 AutoFlushBytes = 64 * 1024;
+
+	/** Destructor. Closes the file if still open */
+	~FShooterSessionLog();
+
+	/** Opens a new log file for the named session. Closes any previously open file */
+	bool Open(const FString& SessionName);
+
+	/** Flushes and closes the log file */
+	void Close();
+
+	/** Appends a single line to the log */
+	void WriteLine(FStringView Line);
+
+	/** Writes buffered lines to disk and waits for them to land */
+	void Flush();
+
+	/** Writes buffered lines to disk on a background task */
+	void FlushAsync();
+
+	/** Returns true if the log file is open */
+	bool IsOpen() const { return Writer.IsValid(); }
+
+	/** Returns the full path of the log file */
+	const FString& GetFilename() const { return Filename; }
+
+protected:
+
+	/** Waits for the background write in flight, if any */
+	void WaitForPendingWrite();
+
+protected:
+
+	/** File writer. Only touched by the write tasks while one is in flight */
+	TSharedPtr<FArchive, ESPMode::ThreadSafe> Writer;
+
+	/** UTF-8 lines waiting to be written */
+	TArray<uint8> Buffer;
+
+	/** Last background write. Writes are chained so they land in order */
+	UE::Tasks::FTask PendingWrite;
+
+	/** Full path of the log file */
+	FString Filename;
+};
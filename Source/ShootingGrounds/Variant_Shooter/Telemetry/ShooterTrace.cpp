@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "ShooterTrace.h"
+
+#if SHOOTER_TRACE_ENABLED
+
+#include "HAL/PlatformTime.h"
+#include "CoreGlobals.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(ShootingGroundsChannel)
+
+UE_TRACE_EVENT_BEGIN(ShootingGrounds, TargetSpawned)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Frame)
+	UE_TRACE_EVENT_FIELD(int32, TargetId)
+	UE_TRACE_EVENT_FIELD(float, X)
+	UE_TRACE_EVENT_FIELD(float, Y)
+	UE_TRACE_EVENT_FIELD(float, Z)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ShootingGrounds, Shot)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Frame)
+	UE_TRACE_EVENT_FIELD(uint32, ShooterId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ShootingGrounds, TargetHit)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Frame)
+	UE_TRACE_EVENT_FIELD(int32, TargetId)
+	UE_TRACE_EVENT_FIELD(float, ReactionTime)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ShootingGrounds, ShotMissed)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Frame)
+	UE_TRACE_EVENT_FIELD(int32, TargetId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ShootingGrounds, RoundStarted)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Frame)
+	UE_TRACE_EVENT_FIELD(int32, Round)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(ShootingGrounds, RoundEnded)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Frame)
+	UE_TRACE_EVENT_FIELD(int32, Round)
+UE_TRACE_EVENT_END()
+
+void FShooterTrace::OutputTargetSpawned(int32 TargetId, const FVector& Location)
+{
+	UE_TRACE_LOG(ShootingGrounds, TargetSpawned, ShootingGroundsChannel)
+		<< TargetSpawned.Cycle(FPlatformTime::Cycles64())
+		<< TargetSpawned.Frame(GFrameCounter)
+		<< TargetSpawned.TargetId(TargetId)
+		<< TargetSpawned.X(static_cast<float>(Location.X))
+		<< TargetSpawned.Y(static_cast<float>(Location.Y))
+		<< TargetSpawned.Z(static_cast<float>(Location.Z));
+}
+
+void FShooterTrace::OutputShot(uint32 ShooterId)
+{
+	UE_TRACE_LOG(ShootingGrounds, Shot, ShootingGroundsChannel)
+		<< Shot.Cycle(FPlatformTime::Cycles64())
+		<< Shot.Frame(GFrameCounter)
+		<< Shot.ShooterId(ShooterId);
+}
+
+void FShooterTrace::OutputTargetHit(int32 TargetId, float ReactionTime)
+{
+	UE_TRACE_LOG(ShootingGrounds, TargetHit, ShootingGroundsChannel)
+		<< TargetHit.Cycle(FPlatformTime::Cycles64())
+		<< TargetHit.Frame(GFrameCounter)
+		<< TargetHit.TargetId(TargetId)
+		<< TargetHit.ReactionTime(ReactionTime);
+}
+
+void FShooterTrace::OutputShotMissed(int32 TargetId)
+{
+	UE_TRACE_LOG(ShootingGrounds, ShotMissed, ShootingGroundsChannel)
+		<< ShotMissed.Cycle(FPlatformTime::Cycles64())
+		<< ShotMissed.Frame(GFrameCounter)
+		<< ShotMissed.TargetId(TargetId);
+}
+
+void FShooterTrace::OutputRoundStarted(int32 Round)
+{
+	UE_TRACE_LOG(ShootingGrounds, RoundStarted, ShootingGroundsChannel)
+		<< RoundStarted.Cycle(FPlatformTime::Cycles64())
+		<< RoundStarted.Frame(GFrameCounter)
+		<< RoundStarted.Round(Round);
+
+	// also drop a bookmark so the round boundaries show up on the timing view
+	TRACE_BOOKMARK(TEXT("Round %d started"), Round);
+}
+
+void FShooterTrace::OutputRoundEnded(int32 Round)
+{
+	UE_TRACE_LOG(ShootingGrounds, RoundEnded, ShootingGroundsChannel)
+		<< RoundEnded.Cycle(FPlatformTime::Cycles64())
+		<< RoundEnded.Frame(GFrameCounter)
+		<< RoundEnded.Round(Round);
+
+	TRACE_BOOKMARK(TEXT("Round %d ended"), Round);
+}
+
+#endif // SHOOTER_TRACE_ENABLED
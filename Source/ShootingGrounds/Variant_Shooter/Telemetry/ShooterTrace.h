@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+#if UE_TRACE_ENABLED && !UE_BUILD_SHIPPING
+	#define SHOOTER_TRACE_ENABLED 1
+#else
+	#define SHOOTER_TRACE_ENABLED 0
+#endif
+
+#if SHOOTER_TRACE_ENABLED
+
+/** Unreal Insights channel for gameplay events. Enable with -trace=default,ShootingGrounds */
+UE_TRACE_CHANNEL_EXTERN(ShootingGroundsChannel, SHOOTINGGROUNDS_API);
+
+/**
+ *  Emits gameplay events to Unreal Insights
+ *  Every event carries the cycle counter and frame number so it can be matched against the CPU and frame tracks
+ *  Use through the SHOOTER_TRACE macro so arguments are not evaluated while the channel is off
+ */
+struct SHOOTINGGROUNDS_API FShooterTrace
+{
+	/** A target was spawned */
+	static void OutputTargetSpawned(int32 TargetId, const FVector& Location);
+
+	/** A weapon was fired */
+	static void OutputShot(uint32 ShooterId);
+
+	/** A target was hit */
+	static void OutputTargetHit(int32 TargetId, float ReactionTime);
+
+	/** A shot missed the current target */
+	static void OutputShotMissed(int32 TargetId);
+
+	/** A round started */
+	static void OutputRoundStarted(int32 Round);
+
+	/** A round ended */
+	static void OutputRoundEnded(int32 Round);
+};
+
+#define SHOOTER_TRACE(EventName, ...) \
+	do \
+	{ \
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(ShootingGroundsChannel)) \
+		{ \
+			FShooterTrace::Output##EventName(__VA_ARGS__); \
+		} \
+	} while (0)
+
+#else
+
+#define SHOOTER_TRACE(EventName, ...) do {} while (0)
+
+#endif
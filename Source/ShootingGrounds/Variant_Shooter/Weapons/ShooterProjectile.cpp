@@ -12,6 +12,8 @@
 #include "Engine/OverlapResult.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "ShooterProjectileSubsystem.h"
+#include "ShootingGrounds.h"
 
 AShooterProjectile::AShooterProjectile()
 {
@@ -39,6 +41,11 @@ AShooterProjectile::AShooterProjectile()
 void AShooterProjectile::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (UShooterProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UShooterProjectileSubsystem>())
+	{
+		Projectiles->AddInFlight();
+	}
 	
 	// ignore the pawn that shot this projectile
 	CollisionComponent->IgnoreActorWhenMoving(GetInstigator(), true);
@@ -48,6 +55,12 @@ void AShooterProjectile::EndPlay(EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
+	// stop counting projectiles that were removed mid flight
+	if (!bHit)
+	{
+		RemoveInFlight();
+	}
+
 	// clear the destruction timer
 	GetWorld()->GetTimerManager().ClearTimer(DestructionTimer);
 }
@@ -61,6 +74,7 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 	}
 
 	bHit = true;
+	RemoveInFlight();
 
 	// disable collision on the projectile
 	CollisionComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
@@ -98,6 +112,8 @@ void AShooterProjectile::NotifyHit(class UPrimitiveComponent* MyComp, AActor* Ot
 
 void AShooterProjectile::ExplosionCheck(const FVector& ExplosionCenter)
 {
+	SHOOTER_SCOPE_STAT(ExplosionCheck);
+
 	// do a sphere overlap check look for nearby actors to damage
 	TArray<FOverlapResult> Overlaps;
 
@@ -165,3 +181,11 @@ void AShooterProjectile::OnDeferredDestruction()
 	// destroy this actor
 	Destroy();
 }
+
+void AShooterProjectile::RemoveInFlight()
+{
+	if (UShooterProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UShooterProjectileSubsystem>())
+	{
+		Projectiles->RemoveInFlight();
+	}
+}
@@ -106,4 +106,7 @@ protected:
 	/** Called from the destruction timer to destroy this projectile */
 	void OnDeferredDestruction();
 
+	/** Stops counting this projectile as in flight in its world */
+	void RemoveInFlight();
+
 };
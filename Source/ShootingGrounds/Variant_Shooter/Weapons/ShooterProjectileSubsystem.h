@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterProjectileSubsystem.generated.h"
+
+/**
+ *  Keeps count of the projectiles flying in a world
+ *  Projectiles register when they begin play and unregister when they hit something or are removed mid flight,
+ *  so the count stays separate for every world running in the process, like PIE clients and servers
+ */
+UCLASS()
+class SHOOTINGGROUNDS_API UShooterProjectileSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Number of projectiles that haven't hit anything yet */
+	int32 NumInFlight = 0;
+
+public:
+
+	/** Counts a projectile that started flying */
+	void AddInFlight() { ++NumInFlight; }
+
+	/** Stops counting a projectile that hit something or was removed */
+	void RemoveInFlight() { NumInFlight = FMath::Max(0, NumInFlight - 1); }
+
+	/** Returns the number of projectiles in flight in this world */
+	int32 GetNumInFlight() const { return NumInFlight; }
+
+protected:
+
+	/** World types this subsystem can be created for */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
@@ -5,12 +5,17 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "ShooterGameMode.h"
+#include "ShootingTarget.h"
 #include "ShooterWeaponHolder.h"
 #include "Components/SceneComponent.h"
 #include "TimerManager.h"
 #include "Animation/AnimInstance.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/Pawn.h"
+#include "GameFramework/Character.h"
+#include "Engine/DamageEvents.h"
+#include "ShooterTrace.h"
+#include "ShootingGrounds.h"
 
 AShooterWeapon::AShooterWeapon()
 {
@@ -125,22 +130,30 @@ void AShooterWeapon::StopFiring()
 
 void AShooterWeapon::Fire()
 {
+	SHOOTER_SCOPE_STAT(WeaponFire);
+
 	// ensure the player still wants to fire. They may have let go of the trigger
 	if (!bIsFiring)
 	{
 		return;
 	}
-	
-	// fire a line trace at the target
-	FHitResult HitOnTarget, HitOffTarget;
-	FVector ShotDirection(0.f);
 
-	bool bHitOnTarget = GunTraceByChannel(HitOnTarget, ShotDirection, ECC_GameTraceChannel4);
-	bool bHitOffTarget = GunTraceByChannel(HitOffTarget, ShotDirection, ECC_GameTraceChannel2);
+	SHOOTER_TRACE(Shot, GetOwner() ? GetOwner()->GetUniqueID() : 0);
 
+	// score the shot in the shooter's training session
 	AShooterGameMode* GameMode = GetWorld() ? Cast<AShooterGameMode>(GetWorld()->GetAuthGameMode()) : nullptr;
-	if (GameMode)
+	AShooterTrainingSession* Session = GameMode ? GameMode->GetSessionForActor(PawnOwner) : nullptr;
+
+	if (Session)
 	{
+		// fire a line trace at the target
+		FHitResult HitOnTarget, HitOffTarget;
+		FVector ShotDirection(0.f);
+
+		// targets of other sessions on the same host share the range, so the traces pass through them
+		bool bHitOnTarget = GunTraceForSession(HitOnTarget, ShotDirection, ECC_GameTraceChannel4, GameMode, Session);
+		bool bHitOffTarget = GunTraceForSession(HitOffTarget, ShotDirection, ECC_GameTraceChannel2, GameMode, Session);
+
 		if(bHitOnTarget) // Make sure this matches your custom channel
 		{
 			DrawDebugSphere(GetWorld(), HitOnTarget.ImpactPoint, 16.f, 12, FColor::Green, false, 2.f);
@@ -152,9 +165,17 @@ void AShooterWeapon::Fire()
 				*HitOnTarget.GetActor()->GetName(),
 				*HitOnTarget.ImpactPoint.ToString()));
 
-				GameMode->TargetShotTimes.Add(GetWorld()->GetTimeSeconds());
-				GameMode->SuccessfulHits++;
-				HitOnTarget.GetActor()->Destroy();
+				Session->OnTargetHit(PawnOwner, HitOnTarget.GetActor(), HitOnTarget.ImpactPoint);
+
+				// pooled targets go back to their spawner, anything else is destroyed
+				if (AShootingTarget* Target = Cast<AShootingTarget>(HitOnTarget.GetActor()))
+				{
+					Target->HandleHit();
+				}
+				else
+				{
+					HitOnTarget.GetActor()->Destroy();
+				}
 		}
 		else
 		{
@@ -164,10 +185,21 @@ void AShooterWeapon::Fire()
 				5.f, 
 				FColor::Red, 
 				FString::Printf(TEXT("Target missed: %s at location: %s"), 
-				*HitOffTarget.GetActor()->GetName(),
+				bHitOffTarget ? *GetNameSafe(HitOffTarget.GetActor()) : TEXT("nothing"),
 				*HitOffTarget.ImpactPoint.ToString()));
 
-				GameMode->MissedShots++;
+				Session->OnShotMissed(PawnOwner, HitOffTarget.ImpactPoint);
+		}
+
+	} else {
+
+		// shooters without a session, like NPCs, aren't scored but deal damage. A burst from about the same view hits the same spot
+		FHitResult Hit;
+		FVector ShotDirection(0.f);
+
+		if (GunTraceCached(Hit, ShotDirection, ECC_GameTraceChannel2))
+		{
+			ApplyShotDamage(Hit, ShotDirection);
 		}
 	}
 
@@ -196,8 +228,88 @@ void AShooterWeapon::FireCooldownExpired()
 	WeaponOwner->OnSemiWeaponRefire();
 }
 
-bool AShooterWeapon::GunTraceByChannel(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel)
+bool AShooterWeapon::GunTraceForSession(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel, const AShooterGameMode* GameMode, const AShooterTrainingSession* Session)
+{
+	TArray<const AActor*, TInlineAllocator<MaxSessionPassThroughs>> IgnoredActors;
+
+	while (GunTraceByChannel(Hit, ShotDirection, Channel, IgnoredActors))
+	{
+		// level geometry and our own session's actors stop the shot
+		const AShooterTrainingSession* HitSession = GameMode->GetSessionForActor(Hit.GetActor());
+
+		if (!HitSession || HitSession == Session)
+		{
+			return true;
+		}
+
+		if (IgnoredActors.Num() >= MaxSessionPassThroughs)
+		{
+			break;
+		}
+
+		// shoot again, through the other session's actor
+		IgnoredActors.Add(Hit.GetActor());
+	}
+
+	return false;
+}
+
+bool AShooterWeapon::GunTraceCached(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel)
+{
+	AController* OwnerController = PawnOwner ? PawnOwner->GetController() : nullptr;
+	if (!OwnerController)
+	{
+		return false;
+	}
+
+	FVector ViewPointLocation;
+	FRotator ViewPointRotation;
+	OwnerController->GetPlayerViewPoint(ViewPointLocation, ViewPointRotation);
+
+	const FVector ViewDirection = ViewPointRotation.Vector();
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	const bool bCacheValid = bHasCachedShot
+		&& CachedShotChannel == Channel
+		&& Now - CachedShotTime <= ShotCacheDuration
+		&& FVector::DistSquared(ViewPointLocation, CachedShotLocation) <= FMath::Square(ShotCacheTolerance)
+		&& FVector::DotProduct(ViewDirection, CachedShotDirection) >= FMath::Cos(FMath::DegreesToRadians(ShotCacheAngle));
+
+	if (!bCacheValid)
+	{
+		bCachedShotBlocked = GunTraceByChannel(CachedShotHit, ShotDirection, Channel);
+		CachedShotChannel = Channel;
+		CachedShotLocation = ViewPointLocation;
+		CachedShotDirection = ViewDirection;
+		CachedShotTime = Now;
+		bHasCachedShot = true;
+	}
+
+	Hit = CachedShotHit;
+	ShotDirection = -ViewDirection;
+
+	return bCachedShotBlocked;
+}
+
+void AShooterWeapon::ApplyShotDamage(const FHitResult& Hit, const FVector& ShotDirection)
 {
+	// a cached hit can outlive its actor
+	ACharacter* HitCharacter = Cast<ACharacter>(Hit.GetActor());
+
+	if (!HitCharacter || HitCharacter == PawnOwner)
+	{
+		return;
+	}
+
+	// the shot direction points back at the shooter
+	const FPointDamageEvent DamageEvent(HitDamage, Hit, -ShotDirection, HitDamageType);
+	HitCharacter->TakeDamage(HitDamage, DamageEvent, PawnOwner->GetController(), this);
+}
+
+bool AShooterWeapon::GunTraceByChannel(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel, TConstArrayView<const AActor*> IgnoredActors)
+{
+	SHOOTER_SCOPE_STAT(GunTrace);
+
 	// // get the projectile transform
 	// FTransform ProjectileTransform = CalculateProjectileSpawnTransform(TargetLocation);
 	
@@ -249,6 +361,11 @@ bool AShooterWeapon::GunTraceByChannel(FHitResult& Hit, FVector& ShotDirection,
 	Params.AddIgnoredActor(this);
 	Params.AddIgnoredActor(GetOwner());
 
+	for (const AActor* IgnoredActor : IgnoredActors)
+	{
+		Params.AddIgnoredActor(IgnoredActor);
+	}
+
 	return GetWorld()->LineTraceSingleByChannel(Hit, ViewPointLocation, End, Channel, Params);
 
 }
@@ -13,6 +13,9 @@ class AShooterProjectile;
 class USkeletalMeshComponent;
 class UAnimMontage;
 class UAnimInstance;
+class AShooterGameMode;
+class AShooterTrainingSession;
+class UDamageType;
 
 /**
  *  Base class for a simple first person shooter weapon
@@ -112,6 +115,42 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Shooting")
 	float MaxRange = 10000.f;
 
+	/** Damage a shot deals to the character it hits. Session shots are scored instead and deal none */
+	UPROPERTY(EditAnywhere, Category="Shooting", meta = (ClampMin = 0, ClampMax = 100))
+	float HitDamage = 10.0f;
+
+	/** Type of damage a shot deals */
+	UPROPERTY(EditAnywhere, Category="Shooting")
+	TSubclassOf<UDamageType> HitDamageType;
+
+	/** Most actors of other sessions a single shot passes through before it gives up */
+	static constexpr int32 MaxSessionPassThroughs = 8;
+
+	/** Time the shot trace of a shooter without a session is reused for, in seconds. Zero traces on every shot */
+	UPROPERTY(EditAnywhere, Category="Shooting", meta = (ClampMin = 0, Units = "s"))
+	float ShotCacheDuration = 0.25f;
+
+	/** Distance the view point can move before the cached shot trace is discarded */
+	UPROPERTY(EditAnywhere, Category="Shooting", meta = (ClampMin = 0, Units = "cm"))
+	float ShotCacheTolerance = 50.0f;
+
+	/** Angle the view can turn before the cached shot trace is discarded */
+	UPROPERTY(EditAnywhere, Category="Shooting", meta = (ClampMin = 0, ClampMax = 90, Units = "Degrees"))
+	float ShotCacheAngle = 2.0f;
+
+	/** View point, view direction and world time of the cached shot trace */
+	FVector CachedShotLocation = FVector::ZeroVector;
+	FVector CachedShotDirection = FVector::ZeroVector;
+	double CachedShotTime = -1.0;
+
+	/** Cached shot trace channel and result */
+	TEnumAsByte<ECollisionChannel> CachedShotChannel = ECC_Visibility;
+	FHitResult CachedShotHit;
+	bool bCachedShotBlocked = false;
+
+	/** True if the cache holds a result */
+	bool bHasCachedShot = false;
+
 public:	
 
 	/** Constructor */
@@ -154,7 +193,16 @@ protected:
 	void FireCooldownExpired();
 
 	/** Fire a line trace towards the target location */
-	virtual bool GunTraceByChannel(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel);
+	virtual bool GunTraceByChannel(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel, TConstArrayView<const AActor*> IgnoredActors = {});
+
+	/** Fire a line trace that passes through the targets and players of other sessions on the same host */
+	bool GunTraceForSession(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel, const AShooterGameMode* GameMode, const AShooterTrainingSession* Session);
+
+	/** Fire a line trace, reusing the last one while the view point and direction stay about the same. Meant for the bursts of shooters without a session */
+	bool GunTraceCached(FHitResult& Hit, FVector& ShotDirection, ECollisionChannel Channel);
+
+	/** Damages the character a shot of a shooter without a session hit */
+	void ApplyShotDamage(const FHitResult& Hit, const FVector& ShotDirection);
 
 	/** Calculates the spawn transform for projectiles shot by this weapon */
 	FTransform CalculateProjectileSpawnTransform(const FVector& TargetLocation) const;